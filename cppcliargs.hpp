@@ -1,18 +1,76 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <bitset>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <limits>
 #include <expected>
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <vector>
 #include <charconv>
 #include <system_error>
+#include <thread>
 #include <iostream>
 
+// List values are split at delimiters with SSE2 where it is available
+// (always on x86-64), or with AVX2 when GCC/Clang can select it at runtime
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPPCLIARGS_SSE2 1
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CPPCLIARGS_AVX2_DISPATCH 1
+#endif
+
+// Response files are mapped where POSIX mmap is available and read into
+// memory otherwise
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CPPCLIARGS_MMAP 1
+#else
+#include <fstream>
+#endif
+
+// Config and response files can be watched for changes where Linux
+// inotify is available
+#if defined(CPPCLIARGS_MMAP) && __has_include(<sys/inotify.h>) && __has_include(<poll.h>)
+#include <poll.h>
+#include <sys/inotify.h>
+#define CPPCLIARGS_INOTIFY 1
+#endif
+
+#if !defined(_WIN32)
+extern "C" char** environ;
+#endif
+
 namespace cppcliargs {
 
 // Error types for std::expected
@@ -22,9 +80,18 @@ enum class ParseError {
     MissingValue,
     InvalidBooleanValue,
     InvalidIntegerValue,
+    InvalidFloatValue,
+    InvalidSizeValue,
+    InvalidDurationValue,
+    InvalidChoice,
+    TooManyValues,
     TypeMismatch,
     DuplicateArgument,
-    InvalidArguments
+    InvalidArguments,
+    ResponseFileError,
+    ConfigFileError,
+    SnapshotError,
+    InputError
 };
 
 // Human-readable error messages
@@ -35,9 +102,18 @@ constexpr std::string_view error_message(ParseError error) noexcept {
         case ParseError::MissingValue: return "Missing value for argument";
         case ParseError::InvalidBooleanValue: return "Invalid boolean value (expected 'true' or 'false')";
         case ParseError::InvalidIntegerValue: return "Invalid integer value";
+        case ParseError::InvalidFloatValue: return "Invalid floating-point value";
+        case ParseError::InvalidSizeValue: return "Invalid size value (expected e.g. 512M or 4KiB)";
+        case ParseError::InvalidDurationValue: return "Invalid duration value (expected e.g. 250ms or 5s)";
+        case ParseError::InvalidChoice: return "Invalid choice";
+        case ParseError::TooManyValues: return "Too many values";
         case ParseError::TypeMismatch: return "Type mismatch";
         case ParseError::DuplicateArgument: return "Duplicate argument";
         case ParseError::InvalidArguments: return "Invalid arguments";
+        case ParseError::ResponseFileError: return "Cannot read response file";
+        case ParseError::ConfigFileError: return "Invalid config file";
+        case ParseError::SnapshotError: return "Invalid snapshot";
+        case ParseError::InputError: return "Cannot read input";
     }
     return "Unknown error";
 }
@@ -61,412 +137,4113 @@ struct ParseErrorInfo {
     }
 };
 
-// Argument value type
-using ArgValue = std::variant<int, bool, std::string>;
+// Byte count given with a unit suffix, e.g. 512M or 4KiB (binary units)
+struct ByteSize {
+    std::uint64_t bytes = 0;
+
+    friend constexpr bool operator==(ByteSize, ByteSize) = default;
+};
+
+// Argument value type; new alternatives go at the end so that existing
+// ones keep their index. Durations are given with a unit suffix, e.g.
+// 250ms or 5s.
+using ArgValue = std::variant<int, bool, std::string, std::int64_t, std::uint64_t, double,
+                              std::vector<int>, std::vector<std::string>,
+                              ByteSize, std::chrono::nanoseconds>;
 using ArgMap = std::map<char, ArgValue>;
 
 // Result type with convenience accessors
-class ParseResultValue {
+template<typename Map>
+class basic_parse_result_value {
 public:
-    explicit ParseResultValue(ArgMap values) : values_(std::move(values)) {}
+    using value_type = typename Map::mapped_type;
+
+    explicit basic_parse_result_value(Map values) : values_(std::move(values)) {}
     
     // Direct access to the map
-    const ArgMap& values() const { return values_; }
+    const Map& values() const { return values_; }
     
     // Iterator support for range-based for loops
     auto begin() const { return values_.begin(); }
     auto end() const { return values_.end(); }
     
     // Subscript operator
-    const ArgValue& operator[](char key) const { return values_.at(key); }
-    const ArgValue& at(char key) const { return values_.at(key); }
+    const value_type& operator[](char key) const { return values_.at(key); }
+    const value_type& at(char key) const { return values_.at(key); }
     
-    // Template-based typed getter
+    // Template-based typed getter; std::string_view views a string value
+    // and std::span<const int> an integer list
     template<typename T>
     T get(char key) const {
-        return std::get<T>(values_.at(key));
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            // The string alternative (std::string or std::pmr::string)
+            return std::get<2>(values_.at(key));
+        } else if constexpr (std::is_same_v<T, std::span<const int>>) {
+            return std::get<6>(values_.at(key));
+        } else {
+            return std::get<T>(values_.at(key));
+        }
     }
     
 private:
-    ArgMap values_;
+    Map values_;
 };
 
+using ParseResultValue = basic_parse_result_value<ArgMap>;
 using ParseResult = std::expected<ParseResultValue, ParseErrorInfo>;
 
-// Configuration structure for parser
-struct Config {
-    ArgMap defaults;
-    std::map<char, std::string> long_names = {};
-    std::set<char> required = {};
-    std::map<char, std::string> help = {};
+// Value and result types whose memory comes from a std::pmr::memory_resource
+namespace pmr {
+
+using ArgValue = std::variant<int, bool, std::pmr::string, std::int64_t, std::uint64_t, double,
+                              std::pmr::vector<int>, std::pmr::vector<std::pmr::string>,
+                              ByteSize, std::chrono::nanoseconds>;
+using ArgMap = std::pmr::map<char, ArgValue>;
+using ParseResultValue = basic_parse_result_value<ArgMap>;
+using ParseResult = std::expected<ParseResultValue, ParseErrorInfo>;
+
+} // namespace pmr
+
+namespace detail {
+
+// One command line token split into option name and inline value
+struct SplitArgument {
+    enum class Kind { Skip, Short, Long };
+
+    Kind kind = Kind::Skip;
+    char short_name = '\0';
+    std::string_view long_name;
+    std::string_view value;
+    bool has_equals = false;
 };
 
-class parser {
-public:
-    // Constructor with defaults and argc/argv
-    parser(ArgMap defaults, int argc, const char* argv[]) noexcept
-        : defaults_(std::move(defaults))
-        , argc_(argc)
-        , argv_(argv)
-    {
-        // Always add -h for help if not present
-        if (!defaults_.contains('h')) {
-            defaults_['h'] = false;
-            long_names_['h'] = "help";
+// Classify "-x", "-x=value", "--name" and "--name=value" tokens
+constexpr SplitArgument split_argument(std::string_view arg) noexcept {
+    // Skip non-arguments, "-" and "--"
+    if (arg.size() < 2 || arg[0] != '-' || arg == "--") {
+        return {};
+    }
+
+    SplitArgument split;
+    if (arg[1] == '-') {
+        split.kind = SplitArgument::Kind::Long;
+        split.long_name = arg.substr(2);
+
+        size_t equals_pos = split.long_name.find('=');
+        if (equals_pos != std::string_view::npos) {
+            split.value = split.long_name.substr(equals_pos + 1);
+            split.long_name = split.long_name.substr(0, equals_pos);
+            split.has_equals = true;
         }
-        
-        // Auto-print help if requested
-        if (has_help_request(argc, argv)) {
-            std::cout << generate_help(argv[0]);
-            help_was_requested_ = true;
+    } else {
+        split.kind = SplitArgument::Kind::Short;
+        split.short_name = arg[1];
+
+        if (arg.size() > 2 && arg[2] == '=') {
+            split.value = arg.substr(3);
+            split.has_equals = true;
         }
     }
-    
-    // Constructor with full Config and argc/argv
-    parser(Config config, int argc, const char* argv[]) noexcept
-        : defaults_(std::move(config.defaults))
-        , long_names_(std::move(config.long_names))
-        , required_(std::move(config.required))
-        , help_(std::move(config.help))
-        , argc_(argc)
-        , argv_(argv)
-    {
-        // Always add -h for help if not present
-        if (!defaults_.contains('h')) {
-            defaults_['h'] = false;
-            long_names_['h'] = "help";
+    return split;
+}
+
+// Lookup of the names of an enum option type (defined with static_parser)
+template<typename E>
+struct choice_traits;
+
+// Unit suffix of a size or duration and how many base units it stands for
+struct UnitSuffix {
+    std::string_view suffix;
+    std::uint64_t scale;
+};
+
+// Largest unit first; the first suffix of each scale is the one help shows
+inline constexpr auto size_units = std::to_array<UnitSuffix>({
+    {"T", 1ull << 40}, {"TB", 1ull << 40}, {"TiB", 1ull << 40},
+    {"G", 1ull << 30}, {"GB", 1ull << 30}, {"GiB", 1ull << 30},
+    {"M", 1ull << 20}, {"MB", 1ull << 20}, {"MiB", 1ull << 20},
+    {"K", 1ull << 10}, {"KB", 1ull << 10}, {"KiB", 1ull << 10},
+    {"B", 1}, {"", 1}
+});
+
+// Scales are in nanoseconds
+inline constexpr auto duration_units = std::to_array<UnitSuffix>({
+    {"d", 86'400'000'000'000}, {"h", 3'600'000'000'000},
+    {"min", 60'000'000'000}, {"m", 60'000'000'000},
+    {"s", 1'000'000'000}, {"ms", 1'000'000}, {"us", 1'000}, {"ns", 1}
+});
+
+// Parse "<count><suffix>" into base units, failing with invalid on an
+// unknown suffix or a result above limit
+template<std::size_t N>
+constexpr std::expected<std::uint64_t, ParseError> parse_scaled(std::string_view value,
+                                                                const std::array<UnitSuffix, N>& units,
+                                                                std::uint64_t limit, ParseError invalid) {
+    std::uint64_t count = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), count);
+    if (ec != std::errc{} || ptr == value.data()) {
+        return std::unexpected(invalid);
+    }
+
+    const std::string_view suffix(ptr, static_cast<std::size_t>(value.data() + value.size() - ptr));
+    const auto unit = std::ranges::find(units, suffix, &UnitSuffix::suffix);
+    if (unit == units.end() || count > limit / unit->scale) {
+        return std::unexpected(invalid);
+    }
+    return count * unit->scale;
+}
+
+// Append value in the largest unit that divides it exactly, e.g. 512M
+template<typename Out, std::size_t N>
+void append_scaled(Out& result, std::uint64_t value, const std::array<UnitSuffix, N>& units) {
+    const UnitSuffix* unit = &units.back();
+    if (value != 0) {
+        unit = &*std::ranges::find_if(units, [&](const UnitSuffix& u) { return value % u.scale == 0; });
+    }
+
+    char digits[24];
+    auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value / unit->scale);
+    result += std::string_view(digits, end - digits);
+    result += unit->suffix;
+}
+
+// Convert a raw value to T, reporting the ParseError a failure maps to
+template<typename T>
+std::expected<T, ParseError> convert_value(std::string_view value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        if (value == "true") {
+            return true;
+        } else if (value == "false") {
+            return false;
         }
-        
-        // Auto-print help if requested
-        if (has_help_request(argc, argv)) {
-            std::cout << generate_help(argv[0]);
-            help_was_requested_ = true;
+        return std::unexpected(ParseError::InvalidBooleanValue);
+    } else if constexpr (std::is_same_v<T, int> || std::is_same_v<T, std::int64_t> ||
+                         std::is_same_v<T, std::uint64_t>) {
+        // Out of range (including a sign on unsigned) is invalid too
+        T result;
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc{} || ptr != value.data() + value.size()) {
+            return std::unexpected(ParseError::InvalidIntegerValue);
+        }
+        return result;
+    } else if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+        T result;
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc{} || ptr != value.data() + value.size()) {
+            return std::unexpected(ParseError::InvalidFloatValue);
+        }
+        return result;
+    } else if constexpr (std::is_same_v<T, ByteSize>) {
+        auto bytes = parse_scaled(value, size_units, UINT64_MAX, ParseError::InvalidSizeValue);
+        if (!bytes) {
+            return std::unexpected(bytes.error());
+        }
+        return ByteSize{*bytes};
+    } else if constexpr (std::is_same_v<T, std::chrono::nanoseconds>) {
+        auto ns = parse_scaled(value, duration_units, INT64_MAX, ParseError::InvalidDurationValue);
+        if (!ns) {
+            return std::unexpected(ns.error());
         }
+        return std::chrono::nanoseconds(static_cast<std::int64_t>(*ns));
+    } else if constexpr (std::is_enum_v<T>) {
+        if (const auto* choice = choice_traits<T>::find(value)) {
+            return choice->value;
+        }
+        return std::unexpected(ParseError::InvalidChoice);
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(value);
+    } else if constexpr (std::is_same_v<T, std::string_view>) {
+        return value;
+    } else {
+        static_assert(sizeof(T) == 0, "unsupported option type");
     }
+}
 
-    // Parse command line arguments using stored argc/argv
-    ParseResult operator()() const {
-        ArgMap result = defaults_;
-        std::set<char> seen_args;
+// Bit i is set where block[i] == delimiter, for the 64 bytes at block
+using DelimiterMask = std::uint64_t (*)(const char* block, char delimiter) noexcept;
 
-        // Convert to span for modern C++ iteration
-        std::span<const char* const> args(argv_, argc_);
-        
-        // Skip program name - iterate from args.begin() + 1
-        for (auto it = args.begin() + 1; it != args.end(); ++it) {
-            std::string_view arg(*it);
-            
-            // Skip non-arguments
-            if (arg.empty() || arg[0] != '-') {
-                continue;
-            }
+inline std::uint64_t delimiter_mask_scalar(const char* block, char delimiter) noexcept {
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i) {
+        mask |= static_cast<std::uint64_t>(block[i] == delimiter) << i;
+    }
+    return mask;
+}
 
-            char arg_char = '\0';
-            std::string_view value_part;
-            bool has_equals = false;
+#ifdef CPPCLIARGS_SSE2
+inline std::uint64_t delimiter_mask_sse2(const char* block, char delimiter) noexcept {
+    const __m128i needle = _mm_set1_epi8(delimiter);
+    std::uint64_t mask = 0;
+    for (int i = 0; i < 64; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        mask |= static_cast<std::uint64_t>(static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)))) << i;
+    }
+    return mask;
+}
+#endif
 
-            // Parse long argument (--xxx)
-            if (arg.size() >= 2 && arg[1] == '-') {
-                if (arg.size() == 2) {
-                    // Just "--" by itself, skip
-                    continue;
-                }
-                
-                std::string_view long_arg = arg.substr(2);
-                
-                // Check for --arg=value format
-                size_t equals_pos = long_arg.find('=');
-                if (equals_pos != std::string_view::npos) {
-                    std::string_view long_name = long_arg.substr(0, equals_pos);
-                    value_part = long_arg.substr(equals_pos + 1);
-                    has_equals = true;
-                    
-                    // Find corresponding short arg
-                    arg_char = find_short_for_long(long_name);
-                } else {
-                    // Just --arg format
-                    arg_char = find_short_for_long(long_arg);
-                }
-                
-                if (arg_char == '\0') {
-                    return std::unexpected(ParseErrorInfo{
-                        ParseError::UnknownArgument,
-                        '-',  // Use '-' for unknown long args
-                        std::string(arg)
-                    });
+#ifdef CPPCLIARGS_AVX2_DISPATCH
+__attribute__((target("avx2")))
+inline std::uint64_t delimiter_mask_avx2(const char* block, char delimiter) noexcept {
+    const __m256i needle = _mm256_set1_epi8(delimiter);
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    return static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle)))) |
+           static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle)))) << 32;
+}
+#endif
+
+// Widest delimiter kernel this CPU supports, chosen on first use
+inline DelimiterMask delimiter_mask() noexcept {
+    static const DelimiterMask kernel = [] {
+#ifdef CPPCLIARGS_AVX2_DISPATCH
+        if (__builtin_cpu_supports("avx2")) {
+            return &delimiter_mask_avx2;
+        }
+#endif
+#ifdef CPPCLIARGS_SSE2
+        return &delimiter_mask_sse2;
+#else
+        return &delimiter_mask_scalar;
+#endif
+    }();
+    return kernel;
+}
+
+// Call field(item) for each delimiter-separated item of text, stopping
+// early (and returning false) as soon as field returns false
+template<typename Field>
+bool for_each_field(std::string_view text, char delimiter, Field&& field) {
+    std::size_t start = 0;
+    std::size_t i = 0;
+    if (text.size() >= 64) {
+        const DelimiterMask mask_of = delimiter_mask();
+        for (; i + 64 <= text.size(); i += 64) {
+            for (std::uint64_t mask = mask_of(text.data() + i, delimiter); mask != 0; mask &= mask - 1) {
+                const std::size_t pos = i + static_cast<std::size_t>(std::countr_zero(mask));
+                if (!field(text.substr(start, pos - start))) {
+                    return false;
                 }
+                start = pos + 1;
             }
-            // Parse short argument (-x)
-            else if (arg.size() >= 2) {
-                arg_char = arg[1];
-                
-                // Check for -x=value format
-                if (arg.size() > 2 && arg[2] == '=') {
-                    value_part = arg.substr(3);
-                    has_equals = true;
-                }
-            } else {
-                // Just "-" by itself, skip
-                continue;
+        }
+    }
+    for (; i < text.size(); ++i) {
+        if (text[i] == delimiter) {
+            if (!field(text.substr(start, i - start))) {
+                return false;
             }
-            
-            // Check if argument is known
-            if (!defaults_.contains(arg_char)) {
-                return std::unexpected(ParseErrorInfo{
-                    ParseError::UnknownArgument,
-                    arg_char,
-                    std::string(arg)
-                });
+            start = i + 1;
+        }
+    }
+    return field(text.substr(start));
+}
+
+// Number of items for_each_field() produces for text
+inline std::size_t count_fields(std::string_view text, char delimiter) noexcept {
+    std::size_t count = 1;
+    std::size_t i = 0;
+    if (text.size() >= 64) {
+        const DelimiterMask mask_of = delimiter_mask();
+        for (; i + 64 <= text.size(); i += 64) {
+            count += static_cast<std::size_t>(std::popcount(mask_of(text.data() + i, delimiter)));
+        }
+    }
+    for (; i < text.size(); ++i) {
+        count += text[i] == delimiter;
+    }
+    return count;
+}
+
+// Append the comma-separated items of a list option's value to out,
+// converted to Item. Room for all of them is reserved before converting,
+// so a long list grows out at most once.
+template<typename Item, typename Out>
+std::expected<void, ParseError> append_list(std::string_view value, Out& out) {
+    if (value.empty()) {
+        return {};
+    }
+
+    const std::size_t needed = out.size() + count_fields(value, ',');
+    if (needed > out.capacity()) {
+        out.reserve(std::max(needed, 2 * out.capacity()));
+    }
+
+    ParseError failure{};
+    const bool appended = for_each_field(value, ',', [&](std::string_view item) {
+        auto converted = convert_value<Item>(item);
+        if (!converted) {
+            failure = converted.error();
+            return false;
+        }
+        out.emplace_back(*converted);
+        return true;
+    });
+    if (!appended) {
+        return std::unexpected(failure);
+    }
+    return {};
+}
+
+// append_list() output that only checks the items convert
+struct DiscardItems {
+    std::size_t size() const noexcept { return 0; }
+    std::size_t capacity() const noexcept { return static_cast<std::size_t>(-1); }
+    void reserve(std::size_t) noexcept {}
+
+    template<typename Item>
+    void emplace_back(const Item&) noexcept {}
+};
+
+// Element type of a list value (std::vector when owned, std::span when
+// borrowed); void for everything else
+template<typename T>
+struct list_item { using type = void; };
+
+template<typename T, typename Allocator>
+struct list_item<std::vector<T, Allocator>> { using type = T; };
+
+template<typename T, std::size_t Extent>
+struct list_item<std::span<T, Extent>> { using type = std::remove_const_t<T>; };
+
+template<typename T>
+using list_item_t = typename list_item<T>::type;
+
+// Element type of a caller-provided array (a std::span of mutable
+// elements); void for everything else
+template<typename T>
+struct array_item { using type = void; };
+
+template<typename T>
+    requires (!std::is_const_v<T>)
+struct array_item<std::span<T>> { using type = T; };
+
+template<typename T>
+using array_item_t = typename array_item<T>::type;
+
+// 64-bit FNV-1a hash of a long option name, or of name appended to text
+// whose hash is hash
+constexpr std::uint64_t hash_name(std::string_view name, std::uint64_t hash = 14695981039346656037ull) noexcept {
+    for (char c : name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Remix a name hash with a bucket's displacement seed (murmur3 finalizer)
+constexpr std::uint32_t displace_hash(std::uint64_t hash, std::uint32_t seed) noexcept {
+    hash ^= seed * 0x9e3779b97f4a7c15ull;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return static_cast<std::uint32_t>(hash);
+}
+
+// Hash-and-displace perfect hash from names to their position in a list.
+// Seeds holds one displacement per first-level bucket, Slots (a power of
+// two in size) holds position + 1 or 0 for empty. Lookup is one hash of
+// the name and two indexed loads; the caller does the single compare.
+template<typename Seeds, typename Slots>
+struct PerfectHash {
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    Seeds seeds{};
+    Slots slots{};
+
+    constexpr std::size_t find(std::string_view name) const noexcept {
+        if (seeds.empty() || slots.empty()) {
+            return npos;
+        }
+        const std::uint64_t hash = hash_name(name);
+        const std::uint32_t seed = seeds[hash % seeds.size()];
+        return static_cast<std::size_t>(slots[displace_hash(hash, seed) & (slots.size() - 1)]) - 1;
+    }
+
+    // Place every distinct name; later duplicates stay unmapped so that
+    // find() reports the first occurrence. Returns false if no seed works.
+    constexpr bool build(std::span<const std::string_view> names) {
+        std::ranges::fill(seeds, 0);
+        std::ranges::fill(slots, 0);
+        if (names.empty()) {
+            return true;
+        }
+
+        std::vector<std::vector<std::size_t>> buckets(seeds.size());
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            auto& bucket = buckets[hash_name(names[i]) % seeds.size()];
+            if (std::ranges::none_of(bucket, [&](std::size_t j) { return names[j] == names[i]; })) {
+                bucket.push_back(i);
             }
+        }
 
-            // Check for duplicate
-            if (seen_args.contains(arg_char)) {
-                return std::unexpected(ParseErrorInfo{
-                    ParseError::DuplicateArgument,
-                    arg_char,
-                    ""
-                });
+        // Place the largest buckets first while the table is still empty
+        std::vector<std::size_t> order(buckets.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = i;
+        }
+        std::ranges::sort(order, [&](std::size_t a, std::size_t b) {
+            return buckets[a].size() != buckets[b].size() ? buckets[a].size() > buckets[b].size() : a < b;
+        });
+
+        const std::size_t mask = slots.size() - 1;
+        std::vector<std::size_t> positions;
+        for (std::size_t b : order) {
+            const auto& bucket = buckets[b];
+            if (bucket.empty()) {
+                break;
             }
-            seen_args.insert(arg_char);
 
-            // Handle value based on type
-            if (has_equals) {
-                // -x=value or --xxx=value format
-                auto parse_result = parse_value(arg_char, value_part);
-                if (!parse_result) {
-                    return std::unexpected(parse_result.error());
-                }
-                result[arg_char] = *parse_result;
-            } else {
-                // For bool types
-                if (std::holds_alternative<bool>(defaults_.at(arg_char))) {
-                    if (required_.contains(arg_char)) {
-                        // Required bool must have explicit value
-                        if (it + 1 >= args.end()) {
-                            return std::unexpected(ParseErrorInfo{
-                                ParseError::MissingValue,
-                                arg_char,
-                                "required boolean needs explicit value"
-                            });
-                        }
-                        ++it;
-                        std::string_view bool_value(*it);
-                        auto parse_result = parse_value(arg_char, bool_value);
-                        if (!parse_result) {
-                            return std::unexpected(parse_result.error());
-                        }
-                        result[arg_char] = *parse_result;
-                    } else {
-                        // Optional bool, presence means true
-                        result[arg_char] = true;
-                    }
-                } else {
-                    // Non-bool types need a value
-                    if (it + 1 >= args.end()) {
-                        return std::unexpected(ParseErrorInfo{
-                            ParseError::MissingValue,
-                            arg_char,
-                            ""
-                        });
+            bool placed = false;
+            for (std::uint32_t seed = 1; seed < (1u << 16) && !placed; ++seed) {
+                positions.clear();
+                placed = true;
+                for (std::size_t i : bucket) {
+                    const std::size_t pos = displace_hash(hash_name(names[i]), seed) & mask;
+                    if (slots[pos] != 0 || std::ranges::find(positions, pos) != positions.end()) {
+                        placed = false;
+                        break;
                     }
-                    ++it;
-                    std::string_view next_value(*it);
-                    auto parse_result = parse_value(arg_char, next_value);
-                    if (!parse_result) {
-                        return std::unexpected(parse_result.error());
+                    positions.push_back(pos);
+                }
+                if (placed) {
+                    seeds[b] = seed;
+                    for (std::size_t k = 0; k < bucket.size(); ++k) {
+                        slots[positions[k]] = static_cast<typename Slots::value_type>(bucket[k] + 1);
                     }
-                    result[arg_char] = *parse_result;
                 }
             }
-        }
-
-        // Check all required arguments are present
-        for (char req : required_) {
-            if (!seen_args.contains(req)) {
-                return std::unexpected(ParseErrorInfo{
-                    ParseError::MissingRequiredArgument,
-                    req,
-                    long_names_.contains(req) ? long_names_.at(req) : ""
-                });
+            if (!placed) {
+                return false;
             }
         }
+        return true;
+    }
+};
 
-        return ParseResultValue(std::move(result));
+// Type label shown in help when an option has no description
+template<typename T>
+constexpr std::string_view type_label() noexcept {
+    if constexpr (std::is_same_v<T, bool>) {
+        return "[boolean]";
+    } else if constexpr (std::is_integral_v<T>) {
+        return "[integer]";
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return "[number]";
+    } else if constexpr (std::is_same_v<T, ByteSize>) {
+        return "[size]";
+    } else if constexpr (std::is_enum_v<T>) {
+        return "[choice]";
+    } else if constexpr (std::is_same_v<T, std::chrono::nanoseconds>) {
+        return "[duration]";
+    } else if constexpr (std::is_same_v<list_item_t<T>, int>) {
+        return "[integer list]";
+    } else if constexpr (!std::is_void_v<list_item_t<T>>) {
+        return "[string list]";
+    } else {
+        return "[string]";
     }
-    
-    // Check if help was requested (simpler name)
-    bool help_requested() const {
-        return help_was_requested_;
+}
+
+// Lets the help helpers below write straight to a stream instead of a
+// std::string (they only use +=, and append(count, c))
+struct StreamAppender {
+    std::ostream& out;
+
+    StreamAppender& operator+=(std::string_view text) {
+        out << text;
+        return *this;
     }
-    
-    // NEW: Report error with auto-generated help
-    void report_error(const ParseResult& result) const {
-        if (!result) {
-            std::cerr << "❌ " << result.error().to_string() << "\n\n";
-            std::cout << generate_help(argv_ ? argv_[0] : "program");
-        }
+
+    StreamAppender& operator+=(char c) {
+        out.put(c);
+        return *this;
     }
 
-private:
-    // Check if help argument is present (internal use)
-    bool has_help_request(int argc, const char* argv[]) const {
-        std::span<const char* const> args(argv, argc);
-        
-        // Skip program name - use range-based for loop with subspan
-        for (const char* arg_ptr : args.subspan(1)) {
-            std::string_view arg(arg_ptr);
-            
-            // Check for -h
-            if (arg == "-h") {
-                return true;
-            }
-            
-            // Check for --help if 'h' has "help" as long name
-            if (long_names_.contains('h') && long_names_.at('h') == "help") {
-                if (arg == "--help") {
-                    return true;
-                }
-            }
+    void append(std::size_t count, char c) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out.put(c);
         }
-        
-        return false;
     }
+};
 
-    // Find short argument character for a long name
-    char find_short_for_long(std::string_view long_name) const {
-        for (const auto& [key, name] : long_names_) {
-            if (name == long_name) {
-                return key;
-            }
+// Append "  -x, --name" padded to the description column
+template<typename Out>
+void append_help_prefix(Out& result, char short_name, std::string_view long_name) {
+    result += "  -";
+    result += short_name;
+
+    if (!long_name.empty()) {
+        result += ", --";
+        result += long_name;
+
+        // Pad to align descriptions
+        size_t current_length = 6 + long_name.length(); // "  -x, --" + name
+        if (current_length < 28) {
+            result.append(28 - current_length, ' ');
         }
-        return '\0';  // Not found
+    } else {
+        // No long name, just pad after short option
+        result.append(24, ' ');
     }
-    // Parse a value based on the type in defaults
-    std::expected<ArgValue, ParseErrorInfo> parse_value(char arg_char, std::string_view value) const {
-        const ArgValue& default_val = defaults_.at(arg_char);
-        
-        if (std::holds_alternative<bool>(default_val)) {
-            if (value == "true") {
-                return true;
-            } else if (value == "false") {
-                return false;
-            }
-            return std::unexpected(ParseErrorInfo{
-                ParseError::InvalidBooleanValue,
-                arg_char,
-                std::string(value)
-            });
-        } else if (std::holds_alternative<int>(default_val)) {
-            int result;
-            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
-            if (ec != std::errc{} || ptr != value.data() + value.size()) {
-                return std::unexpected(ParseErrorInfo{
-                    ParseError::InvalidIntegerValue,
-                    arg_char,
-                    std::string(value)
-                });
-            }
-            return result;
-        } else if (std::holds_alternative<std::string>(default_val)) {
-            return std::string(value);
-        }
+}
 
-        return std::unexpected(ParseErrorInfo{
-            ParseError::TypeMismatch,
-            arg_char,
-            ""
-        });
+// Append the " (default: ...)" / " (required)" suffix of a help line
+template<typename Out, typename T>
+void append_help_default(Out& result, const T& default_value, bool required) {
+    if constexpr (std::is_enum_v<T>) {
+        // List the accepted names, e.g. " {fast|safe|debug}"
+        result += " {";
+        choice_traits<T>::append_names(result);
+        result += "}";
     }
 
-    ArgMap defaults_;
-    std::map<char, std::string> long_names_;
-    std::set<char> required_;
-    std::map<char, std::string> help_;
-    
-    // Stored command line arguments (when using improved constructor)
-    int argc_ = 0;
-    const char** argv_ = nullptr;
-    mutable bool help_was_requested_ = false;
-
-public:
-    // Generate help text
-    std::string generate_help(const std::string& program_name = "program") const {
-        std::string result;
-        result += "Usage: " + program_name + " [OPTIONS]\n\n";
-        result += "Options:\n";
-        
-        // Collect all argument characters and sort them
-        std::vector<char> args;
-        for (const auto& [key, _] : defaults_) {
-            args.push_back(key);
+    if (required) {
+        result += " (required)";
+    } else if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) {
+        char digits[32];
+        auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), default_value);
+        result += " (default: ";
+        result += std::string_view(digits, end - digits);
+        result += ")";
+    } else if constexpr (std::is_enum_v<T>) {
+        if (const std::string_view name = choice_traits<T>::name_of(default_value); !name.empty()) {
+            result += " (default: ";
+            result += name;
+            result += ")";
         }
-        std::sort(args.begin(), args.end());
-        
-        // Generate help line for each argument
-        for (char arg : args) {
-            result += "  -";
-            result += arg;
-            
-            // Add long name if present
-            if (long_names_.contains(arg)) {
-                result += ", --";
-                result += long_names_.at(arg);
-                
-                // Pad to align descriptions
-                size_t current_length = 6 + long_names_.at(arg).length(); // "  -x, --" + name
-                if (current_length < 28) {
-                    result += std::string(28 - current_length, ' ');
-                }
-            } else {
-                // No long name, just pad after short option
-                result += std::string(24, ' ');
-            }
-            
-            // Add help text if present, otherwise show type
-            if (help_.contains(arg)) {
-                result += help_.at(arg);
-            } else {
-                // Show type when no help text provided
-                const auto& default_val = defaults_.at(arg);
-                if (std::holds_alternative<int>(default_val)) {
-                    result += "[integer]";
-                } else if (std::holds_alternative<bool>(default_val)) {
-                    result += "[boolean]";
-                } else if (std::holds_alternative<std::string>(default_val)) {
-                    result += "[string]";
-                }
-            }
-            
-            // Add default value
-            const auto& default_val = defaults_.at(arg);
-            
-            if (std::holds_alternative<int>(default_val)) {
-                int def = std::get<int>(default_val);
-                if (!required_.contains(arg)) {
-                    result += " (default: " + std::to_string(def) + ")";
-                } else {
-                    result += " (required)";
-                }
-            } else if (std::holds_alternative<bool>(default_val)) {
-                if (required_.contains(arg)) {
-                    result += " (required)";
+    } else if constexpr (std::is_same_v<T, ByteSize>) {
+        result += " (default: ";
+        append_scaled(result, default_value.bytes, size_units);
+        result += ")";
+    } else if constexpr (std::is_same_v<T, std::chrono::nanoseconds>) {
+        const auto magnitude = static_cast<std::uint64_t>(default_value.count());
+        result += " (default: ";
+        if (default_value.count() < 0) {
+            result += "-";
+        }
+        append_scaled(result, default_value.count() < 0 ? 0 - magnitude : magnitude, duration_units);
+        result += ")";
+    } else if constexpr (std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>) {
+        if (!default_value.empty()) {
+            result += " (default: \"";
+            result += default_value;
+            result += "\")";
+        }
+    } else if constexpr (!std::is_void_v<list_item_t<T>>) {
+        if (!default_value.empty()) {
+            result += " (default: ";
+            for (std::size_t i = 0; i < default_value.size(); ++i) {
+                if (i != 0) {
+                    result += ",";
                 }
-            } else if (std::holds_alternative<std::string>(default_val)) {
-                const auto& def = std::get<std::string>(default_val);
-                if (!required_.contains(arg)) {
-                    if (!def.empty()) {
-                        result += " (default: \"" + def + "\")";
-                    }
+                if constexpr (std::is_same_v<list_item_t<T>, int>) {
+                    char digits[16];
+                    auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), default_value[i]);
+                    result += std::string_view(digits, end - digits);
                 } else {
-                    result += " (required)";
+                    result += std::string_view(default_value[i]);
                 }
             }
-            
-            result += "\n";
+            result += ")";
+        }
+    }
+}
+
+// Build the error for a non-empty mask of missing required options. The
+// first one is reported as the argument; when several are missing the
+// detail lists all of them.
+template<typename LongName>
+ParseErrorInfo missing_required_error(const std::bitset<256>& missing, LongName long_name) {
+    char first = '\0';
+    std::string listed;
+    for (std::size_t bit = 0; bit < missing.size(); ++bit) {
+        if (missing.test(bit)) {
+            const auto key = static_cast<char>(static_cast<unsigned char>(bit));
+            if (listed.empty()) {
+                first = key;
+            } else {
+                listed += ", ";
+            }
+            listed += '-';
+            listed += key;
         }
-        
-        return result;
     }
+
+    if (missing.count() == 1) {
+        return ParseErrorInfo{ParseError::MissingRequiredArgument, first, std::string(long_name(first))};
+    }
+    return ParseErrorInfo{ParseError::MissingRequiredArgument, first, "all missing: " + listed};
+}
+
+} // namespace detail
+
+// Configuration structure for parser
+struct Config {
+    ArgMap defaults;
+    std::map<char, std::string> long_names = {};
+    std::set<char> required = {};
+    std::map<char, std::string> help = {};
+    // Environment variables (env_prefix + name) that supply options not
+    // given on the command line, e.g. {'t', "THREADS"} with "MYAPP_"
+    std::string env_prefix = {};
+    std::map<char, std::string> env_names = {};
+    // File of key = value lines for options given neither on the command
+    // line nor in the environment; keys are long or short option names
+    std::string config_file = {};
+};
+
+namespace pmr {
+
+// Config whose containers use a memory resource; the parser allocates its
+// option table from the resource of defaults
+struct Config {
+    ArgMap defaults;
+    std::pmr::map<char, std::pmr::string> long_names = {};
+    std::pmr::set<char> required = {};
+    std::pmr::map<char, std::pmr::string> help = {};
+    std::pmr::string env_prefix = {};
+    std::pmr::map<char, std::pmr::string> env_names = {};
+    std::pmr::string config_file = {};
+};
+
+} // namespace pmr
+
+// Argument value that borrows strings and lists instead of owning them
+using BorrowedArgValue = std::variant<int, bool, std::string_view, std::int64_t, std::uint64_t, double,
+                                      std::span<const int>, std::span<const std::string_view>,
+                                      ByteSize, std::chrono::nanoseconds>;
+
+// Result of parse_into(): success, or the error that stopped parsing
+using ParseStatus = std::expected<void, ParseErrorInfo>;
+
+// Parse the comma-separated numbers in text straight into out and return
+// how many were written. Items convert as single int, float or double
+// options do; more items than out holds fail with TooManyValues.
+template<typename T>
+std::expected<std::size_t, ParseError> parse_array(std::string_view text, std::span<T> out) {
+    static_assert(std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "parse_array supports int, float and double");
+    if (text.empty()) {
+        return 0;
+    }
+    if (detail::count_fields(text, ',') > out.size()) {
+        return std::unexpected(ParseError::TooManyValues);
+    }
+
+    std::size_t count = 0;
+    ParseError failure{};
+    const bool parsed = detail::for_each_field(text, ',', [&](std::string_view item) {
+        auto converted = detail::convert_value<T>(item);
+        if (!converted) {
+            failure = converted.error();
+            return false;
+        }
+        out[count++] = *converted;
+        return true;
+    });
+    if (!parsed) {
+        return std::unexpected(failure);
+    }
+    return count;
+}
+
+namespace detail {
+
+// Value type tag, numbered after the ArgValue alternatives (None = unknown)
+enum class ValueType : std::uint8_t {
+    None,
+    Int,
+    Bool,
+    String,
+    Int64,
+    UInt64,
+    Double,
+    IntList,
+    StringList,
+    Size,
+    Duration
+};
+
+template<typename Value>
+constexpr ValueType value_type_of(const Value& value) noexcept {
+    return static_cast<ValueType>(value.index() + 1);
+}
+
+// List options may be repeated; every occurrence appends to the list
+constexpr bool is_list(ValueType type) noexcept {
+    return type == ValueType::IntList || type == ValueType::StringList;
+}
+
+// Alternative of an ArgValue-like variant holding values of a type tag
+template<typename Value, ValueType Type>
+using alternative_t = std::variant_alternative_t<static_cast<std::size_t>(Type) - 1, Value>;
+
+// Copy a BorrowedArgValue into an owning ArgValue-like variant whose
+// string is allocated with alloc
+template<typename Value, typename Allocator>
+Value own_value(const BorrowedArgValue& value, const Allocator& alloc) {
+    using String = alternative_t<Value, ValueType::String>;
+    using IntList = alternative_t<Value, ValueType::IntList>;
+    using StringList = alternative_t<Value, ValueType::StringList>;
+    return std::visit([&](const auto& v) -> Value {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return Value(std::in_place_type<String>, v, typename String::allocator_type(alloc));
+        } else if constexpr (std::is_same_v<T, std::span<const int>>) {
+            return Value(std::in_place_type<IntList>, v.begin(), v.end(), typename IntList::allocator_type(alloc));
+        } else if constexpr (std::is_same_v<T, std::span<const std::string_view>>) {
+            return Value(std::in_place_type<StringList>, v.begin(), v.end(), typename StringList::allocator_type(alloc));
+        } else {
+            return v;
+        }
+    }, value);
+}
+
+// One entry of OptionTable; strings are offsets into the table's pool
+struct OptionSlot {
+    ValueType type = ValueType::None;
+    bool required = false;
+    std::uint16_t default_index = 0;
+    std::uint16_t long_name_length = 0;
+    std::uint16_t help_length = 0;
+    std::uint32_t long_name_offset = 0;
+    std::uint32_t help_offset = 0;
+};
+static_assert(sizeof(OptionSlot) == 16, "OptionSlot should stay 16 bytes");
+
+// Config compiled into a flat table directly indexed by unsigned char
+class OptionTable {
+public:
+    OptionTable() = default;
+
+    // Compile a Config or pmr::Config, adding -h/--help if not present
+    template<typename ConfigT>
+    explicit OptionTable(const ConfigT& config,
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : defaults_(resource)
+        , options_(resource)
+        , long_options_(resource)
+        , long_index_{std::pmr::vector<std::uint32_t>(resource), std::pmr::vector<std::uint16_t>(resource)}
+        , env_options_(resource)
+        , env_names_(resource)
+        , env_index_{std::pmr::vector<std::uint32_t>(resource), std::pmr::vector<std::uint16_t>(resource)}
+    {
+        using DefaultValue = typename decltype(config.defaults)::mapped_type;
+        using StringDefault = alternative_t<DefaultValue, ValueType::String>;
+        using IntListDefault = alternative_t<DefaultValue, ValueType::IntList>;
+        using StringListDefault = alternative_t<DefaultValue, ValueType::StringList>;
+        auto pool = std::allocate_shared<std::pmr::string>(std::pmr::polymorphic_allocator<>(resource));
+        struct PooledDefault { std::size_t index, offset, length; };
+        std::pmr::vector<PooledDefault> string_defaults(resource);
+        // List defaults are spans into lists, made once it stops growing;
+        // string items are first recorded as pool offsets
+        std::shared_ptr<ListPool> lists;
+        std::pmr::vector<PooledDefault> int_list_defaults(resource);
+        std::pmr::vector<PooledDefault> string_list_defaults(resource);
+        std::pmr::vector<PooledDefault> string_items(resource);
+
+        for (char key : config.required) {
+            required_.set(static_cast<unsigned char>(key));
+        }
+
+        for (const auto& [key, value] : config.defaults) {
+            OptionSlot& entry = add_option(key, value_type_of(value));
+
+            if (is_list(entry.type) && !lists) {
+                lists = std::allocate_shared<ListPool>(std::pmr::polymorphic_allocator<>(resource),
+                    ListPool{std::pmr::vector<int>(resource), std::pmr::vector<std::string_view>(resource)});
+            }
+
+            if (const auto* text = std::get_if<StringDefault>(&value)) {
+                // Pointed at the pool once it stops growing
+                string_defaults.push_back({entry.default_index, pool->size(), text->size()});
+                pool->append(*text);
+            } else if (const auto* items = std::get_if<IntListDefault>(&value)) {
+                int_list_defaults.push_back({entry.default_index, lists->ints.size(), items->size()});
+                lists->ints.insert(lists->ints.end(), items->begin(), items->end());
+            } else if (const auto* items = std::get_if<StringListDefault>(&value)) {
+                string_list_defaults.push_back({entry.default_index, string_items.size(), items->size()});
+                for (const auto& item : *items) {
+                    string_items.push_back({0, pool->size(), item.size()});
+                    pool->append(item);
+                }
+            } else {
+                defaults_.back() = std::visit([](const auto& v) -> BorrowedArgValue {
+                    if constexpr (std::is_trivially_copyable_v<std::decay_t<decltype(v)>>) {
+                        return v;
+                    } else {
+                        return {};  // Not reached: strings and lists are handled above
+                    }
+                }, value);
+            }
+
+            if (auto name = config.long_names.find(key); name != config.long_names.end()) {
+                entry.long_name_offset = intern(*pool, name->second, entry.long_name_length);
+                long_options_.push_back(key);
+            }
+            if (auto text = config.help.find(key); text != config.help.end()) {
+                entry.help_offset = intern(*pool, text->second, entry.help_length);
+            }
+            if (auto name = config.env_names.find(key); name != config.env_names.end()) {
+                PooledName& pooled = env_names_.emplace_back();
+                pooled.offset = intern(*pool, name->second, pooled.length);
+                env_options_.push_back(key);
+            }
+        }
+        if (!env_options_.empty()) {
+            env_prefix_.offset = intern(*pool, config.env_prefix, env_prefix_.length);
+        }
+
+        // Always add -h for help if not present
+        if (!contains('h')) {
+            OptionSlot& entry = add_option('h', ValueType::Bool);
+            defaults_.back() = false;
+            entry.long_name_offset = intern(*pool, "help", entry.long_name_length);
+            long_options_.push_back('h');
+            std::ranges::sort(options_);
+        }
+
+        pool_ = std::move(pool);
+        for (const auto& pooled : string_defaults) {
+            defaults_[pooled.index] = text().substr(pooled.offset, pooled.length);
+        }
+        if (lists) {
+            for (const auto& item : string_items) {
+                lists->strings.push_back(text().substr(item.offset, item.length));
+            }
+            for (const auto& list : int_list_defaults) {
+                defaults_[list.index] = std::span<const int>(lists->ints).subspan(list.offset, list.length);
+            }
+            for (const auto& list : string_list_defaults) {
+                defaults_[list.index] = std::span<const std::string_view>(lists->strings).subspan(list.offset, list.length);
+            }
+            lists_ = std::move(lists);
+        }
+        build_long_index();
+        build_env_index();
+    }
+
+    const OptionSlot& slot(char key) const noexcept {
+        return slots_[static_cast<unsigned char>(key)];
+    }
+
+    bool contains(char key) const noexcept {
+        return slot(key).type != ValueType::None;
+    }
+
+    const BorrowedArgValue& default_value(char key) const noexcept {
+        return defaults_[slot(key).default_index];
+    }
+
+    // Defaults of all options by default_index; strings view the table's pool
+    const std::pmr::vector<BorrowedArgValue>& defaults() const noexcept { return defaults_; }
+
+    std::string_view long_name(char key) const noexcept {
+        const OptionSlot& entry = slot(key);
+        return text().substr(entry.long_name_offset, entry.long_name_length);
+    }
+
+    std::string_view help(char key) const noexcept {
+        const OptionSlot& entry = slot(key);
+        return text().substr(entry.help_offset, entry.help_length);
+    }
+
+    // Known options in ascending order
+    const std::pmr::vector<char>& options() const noexcept { return options_; }
+
+    // Required options as a mask over unsigned char (may include undeclared ones)
+    const std::bitset<256>& required() const noexcept { return required_; }
+
+    // Whether any option is a list
+    bool has_lists() const noexcept { return lists_ != nullptr; }
+
+    // Find short argument character for a long name
+    char find_long(std::string_view name) const noexcept {
+        const std::size_t index = long_index_.find(name);
+        if (index < long_options_.size() && long_name(long_options_[index]) == name) {
+            return long_options_[index];
+        }
+        return '\0';  // Not found
+    }
+
+    // Hash of what a parsed value depends on: each option's name, type
+    // and long name
+    std::uint64_t schema_hash() const noexcept {
+        std::uint64_t hash = hash_name("cppcliargs schema");
+        for (char key : options_) {
+            const char header[] = {key, static_cast<char>(slot(key).type)};
+            hash = hash_name(std::string_view(header, sizeof(header)), hash);
+            hash = hash_name(long_name(key), hash);
+            hash = hash_name(std::string_view("", 1), hash);
+        }
+        return hash;
+    }
+
+    // Whether any option can be set from the environment
+    bool has_env() const noexcept { return !env_options_.empty(); }
+
+    // Find short argument character for a full environment variable name
+    char find_env(std::string_view variable) const noexcept {
+        const std::string_view prefix = pooled(env_prefix_);
+        if (!variable.starts_with(prefix)) {
+            return '\0';
+        }
+        const std::string_view name = variable.substr(prefix.size());
+        const std::size_t index = env_index_.find(name);
+        if (index < env_options_.size() && pooled(env_names_[index]) == name) {
+            return env_options_[index];
+        }
+        return '\0';
+    }
+
+private:
+    struct PooledName {
+        std::uint32_t offset = 0;
+        std::uint16_t length = 0;
+    };
+
+    // Items of list defaults
+    struct ListPool {
+        std::pmr::vector<int> ints;
+        std::pmr::vector<std::string_view> strings;
+    };
+
+    OptionSlot& add_option(char key, ValueType type) {
+        OptionSlot& entry = slots_[static_cast<unsigned char>(key)];
+        entry.type = type;
+        entry.required = required_.test(static_cast<unsigned char>(key));
+        entry.default_index = static_cast<std::uint16_t>(defaults_.size());
+        defaults_.emplace_back();
+        options_.push_back(key);
+        return entry;
+    }
+
+    std::string_view text() const noexcept {
+        return pool_ ? std::string_view(*pool_) : std::string_view{};
+    }
+
+    std::string_view pooled(PooledName name) const noexcept {
+        return text().substr(name.offset, name.length);
+    }
+
+    void build_long_index() {
+        std::vector<std::string_view> names;
+        for (char key : long_options_) {
+            names.push_back(long_name(key));
+        }
+        build_index(long_index_, names);
+    }
+
+    void build_env_index() {
+        std::vector<std::string_view> names;
+        for (PooledName name : env_names_) {
+            names.push_back(pooled(name));
+        }
+        build_index(env_index_, names);
+    }
+
+    template<typename Index>
+    static void build_index(Index& index, std::span<const std::string_view> names) {
+        // Load factor <= 1/2; widen the table in the unlikely case no seed fits
+        index.seeds.resize(names.size());
+        for (std::size_t size = std::bit_ceil(2 * names.size()); size <= (1u << 16); size *= 2) {
+            index.slots.resize(size);
+            if (index.build(names)) {
+                return;
+            }
+        }
+    }
+
+    static std::uint32_t intern(std::pmr::string& pool, std::string_view text, std::uint16_t& length) {
+        const auto offset = static_cast<std::uint32_t>(pool.size());
+        length = static_cast<std::uint16_t>(std::min<size_t>(text.size(), UINT16_MAX));
+        pool.append(text.substr(0, length));
+        return offset;
+    }
+
+    std::array<OptionSlot, 256> slots_{};
+    std::pmr::vector<BorrowedArgValue> defaults_;
+    // Immutable and shared between copies so the string_views stay valid
+    std::shared_ptr<const std::pmr::string> pool_;
+    std::shared_ptr<const ListPool> lists_;
+    std::pmr::vector<char> options_;
+    std::pmr::vector<char> long_options_;
+    std::bitset<256> required_;
+    PerfectHash<std::pmr::vector<std::uint32_t>, std::pmr::vector<std::uint16_t>> long_index_;
+    // Options read from the environment; names exclude the shared prefix
+    PooledName env_prefix_;
+    std::pmr::vector<char> env_options_;
+    std::pmr::vector<PooledName> env_names_;
+    PerfectHash<std::pmr::vector<std::uint32_t>, std::pmr::vector<std::uint16_t>> env_index_;
+};
+
+// Convert a raw value according to its type tag; strings stay views.
+// Lists need storage of their own and are appended with append_list().
+inline std::expected<BorrowedArgValue, ParseError> convert_borrowed(ValueType type, std::string_view value) {
+    switch (type) {
+        case ValueType::Int: return convert_value<int>(value);
+        case ValueType::Bool: return convert_value<bool>(value);
+        case ValueType::String: return value;
+        case ValueType::Int64: return convert_value<std::int64_t>(value);
+        case ValueType::UInt64: return convert_value<std::uint64_t>(value);
+        case ValueType::Double: return convert_value<double>(value);
+        case ValueType::Size: return convert_value<ByteSize>(value);
+        case ValueType::Duration: return convert_value<std::chrono::nanoseconds>(value);
+        case ValueType::IntList:
+        case ValueType::StringList:
+        case ValueType::None: break;
+    }
+    return std::unexpected(ParseError::TypeMismatch);
+}
+
+// A whole file mapped copy-on-write: it can be modified in memory without
+// touching the file. Empty files have no mapping.
+class MappedFile {
+public:
+#ifdef CPPCLIARGS_MMAP
+    struct Id {
+        dev_t device;
+        ino_t inode;
+        bool operator==(const Id&) const = default;
+    };
+#else
+    using Id = std::string;  // the path as given
+#endif
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)), id_(std::move(other.id_)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            id_ = std::move(other.id_);
+        }
+        return *this;
+    }
+
+    ~MappedFile() {
+        release();
+    }
+
+    // Map path, or describe why it cannot be read
+    static std::expected<MappedFile, std::string> open(const std::string& path) {
+        MappedFile file;
+#ifdef CPPCLIARGS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::unexpected(std::generic_category().message(errno));
+        }
+        struct stat info {};
+        int error = 0;
+        if (::fstat(fd, &info) != 0) {
+            error = errno;
+        } else if (!S_ISREG(info.st_mode)) {
+            error = S_ISDIR(info.st_mode) ? EISDIR : EINVAL;
+        }
+        if (error != 0) {
+            ::close(fd);
+            return std::unexpected(std::generic_category().message(error));
+        }
+        file.id_ = Id{info.st_dev, info.st_ino};
+        if (info.st_size > 0) {
+            void* data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                return std::unexpected(std::generic_category().message(error));
+            }
+            ::madvise(data, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+            file.data_ = static_cast<char*>(data);
+            file.size_ = static_cast<std::size_t>(info.st_size);
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            return std::unexpected(std::string("cannot open file"));
+        }
+        const auto size = static_cast<std::size_t>(in.tellg());
+        file.id_ = path;
+        if (size > 0) {
+            file.data_ = new char[size];
+            file.size_ = size;
+            in.seekg(0);
+            if (!in.read(file.data_, static_cast<std::streamsize>(size))) {
+                return std::unexpected(std::string("cannot read file"));
+            }
+        }
+#endif
+        return file;
+    }
+
+    char* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    const Id& id() const noexcept { return id_; }
+
+private:
+    void release() noexcept {
+        if (data_ == nullptr) {
+            return;
+        }
+#ifdef CPPCLIARGS_MMAP
+        ::munmap(data_, size_);
+#else
+        delete[] data_;
+#endif
+        data_ = nullptr;
+    }
+
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+    Id id_{};
+};
+
+// Read the whole file at path into storage of its own: allocate(size)
+// returns where to put size bytes. Returns the number of bytes read, or
+// why the file cannot be read. Unlike a mapping, the copy is unaffected
+// by later changes to the file.
+template<typename Allocate>
+std::expected<std::size_t, std::string> read_file(const std::string& path, Allocate&& allocate) {
+#ifdef CPPCLIARGS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return std::unexpected(std::generic_category().message(errno));
+    }
+    struct stat info {};
+    int error = 0;
+    if (::fstat(fd, &info) != 0) {
+        error = errno;
+    } else if (!S_ISREG(info.st_mode)) {
+        error = S_ISDIR(info.st_mode) ? EISDIR : EINVAL;
+    }
+    std::size_t size = 0;
+    if (error == 0) {
+        // A file that shrinks meanwhile is read to its end; one that grows
+        // is read up to its size at fstat()
+        char* const data = allocate(static_cast<std::size_t>(info.st_size));
+        while (size < static_cast<std::size_t>(info.st_size)) {
+            const ::ssize_t count = ::read(fd, data + size, static_cast<std::size_t>(info.st_size) - size);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                error = count < 0 ? errno : 0;
+                break;
+            }
+            size += static_cast<std::size_t>(count);
+        }
+    }
+    ::close(fd);
+    if (error != 0) {
+        return std::unexpected(std::generic_category().message(error));
+    }
+    return size;
+#else
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        return std::unexpected(std::string("cannot open file"));
+    }
+    const auto size = static_cast<std::size_t>(in.tellg());
+    char* const data = allocate(size);
+    in.seekg(0);
+    if (!in.read(data, static_cast<std::streamsize>(size))) {
+        return std::unexpected(std::string("cannot read file"));
+    }
+    return size;
+#endif
+}
+
+constexpr std::string_view trim(std::string_view text) noexcept {
+    const auto is_blank = [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f'; };
+    while (!text.empty() && is_blank(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && is_blank(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// One setting of a config file, resolved to its option
+struct FileEntry {
+    char key;
+    std::string_view value;
+    std::string_view line;  // reported if the value is rejected
+};
+
+// A config file read once into memory of its own and split into entries
+// whose values view that copy. Lines are "key = value", where key is a
+// long option name or a short one and the value may be wrapped in
+// matching quotes; blank lines, lines starting with '#' or ';' and
+// [section] headers are skipped. A file that cannot be used keeps the
+// reason in error().
+class ConfigFileLayer {
+public:
+    ConfigFileLayer(const OptionTable& table, const std::string& path, std::pmr::memory_resource* resource)
+        : path_(path, resource)
+        , text_(resource)
+        , entries_(resource)
+    {
+        auto read = read_file(path, [&](std::size_t size) {
+            text_.resize(size);
+            return text_.data();
+        });
+        if (!read) {
+            error_ = ParseErrorInfo{ParseError::ConfigFileError, '-', path + ": " + read.error()};
+            return;
+        }
+        text_.resize(*read);
+
+        const char* next = text_.data();
+        const char* const end = next + text_.size();
+        for (std::size_t line_number = 1; next < end; ++line_number) {
+            const char* newline = static_cast<const char*>(std::memchr(next, '\n', static_cast<std::size_t>(end - next)));
+            const char* const line_end = newline != nullptr ? newline : end;
+            const std::string_view line = trim(std::string_view(next, static_cast<std::size_t>(line_end - next)));
+            next = line_end + 1;
+
+            if (line.empty() || line.front() == '#' || line.front() == ';' ||
+                (line.front() == '[' && line.back() == ']')) {
+                continue;
+            }
+
+            auto fail = [&](ParseError error, char argument, std::string_view reason) {
+                error_ = ParseErrorInfo{error, argument, path + ":" + std::to_string(line_number) + ": "};
+                error_->detail += reason;
+                entries_.clear();
+            };
+
+            const std::size_t equals = line.find('=');
+            if (equals == std::string_view::npos) {
+                fail(ParseError::ConfigFileError, '-', "expected key = value");
+                return;
+            }
+            const std::string_view name = trim(line.substr(0, equals));
+            std::string_view value = trim(line.substr(equals + 1));
+            if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+                value = value.substr(1, value.size() - 2);
+            }
+
+            char key = table.find_long(name);
+            if (key == '\0' && name.size() == 1 && table.contains(name.front())) {
+                key = name.front();
+            }
+            if (key == '\0') {
+                fail(ParseError::UnknownArgument, name.size() == 1 ? name.front() : '-', name);
+                return;
+            }
+            entries_.push_back(FileEntry{key, value, line});
+        }
+    }
+
+    std::span<const FileEntry> entries() const noexcept { return entries_; }
+    const std::optional<ParseErrorInfo>& error() const noexcept { return error_; }
+    std::string_view path() const noexcept { return path_; }
+
+private:
+    std::pmr::string path_;
+    std::pmr::string text_;
+    std::pmr::vector<FileEntry> entries_;
+    std::optional<ParseErrorInfo> error_;
+};
+
+// Non-owning description of why a command line was rejected. index is
+// the position of the offending token in args (-1 if there is none).
+struct RawParseError {
+    ParseError error;
+    char argument;
+    int index;
+    std::string_view detail;
+    std::bitset<256> missing = {};  // Every missing option for MissingRequiredArgument
+};
+
+// The process environment as a null-terminated array of NAME=value entries
+inline const char* const* environment() noexcept {
+#if defined(_WIN32)
+    return _environ;
+#else
+    return environ;
+#endif
+}
+
+// Walk a command line once (args[0] is the program name), validating
+// options against table and handing each one's raw value to
+// store(arg_char, slot, value, repeated), which returns the ParseError a
+// bad value maps to. Optional bools given without a value are stored as
+// "true". Only list options may be repeated; repeated is true for every
+// occurrence after the first. Options not given are then looked up in a
+// single scan of env (NAME=value entries), if the table maps variable
+// names to options, and finally in the entries of a config file. Nothing
+// here allocates.
+template<typename Table, typename Args, typename Store>
+std::expected<void, RawParseError> walk_arguments(const Table& table, const Args& args, Store&& store,
+                                                  const char* const* env = nullptr,
+                                                  std::span<const FileEntry> file = {}) {
+    std::bitset<256> seen_args;
+    const int count = static_cast<int>(std::ranges::size(args));
+
+    // Skip program name
+    for (int i = 1; i < count; ++i) {
+        const std::string_view arg(args[i]);
+        const SplitArgument split = split_argument(arg);
+
+        char arg_char = '\0';
+        std::string_view value = split.value;
+
+        if (split.kind == SplitArgument::Kind::Skip) {
+            continue;
+        } else if (split.kind == SplitArgument::Kind::Long) {
+            // Find corresponding short arg
+            arg_char = table.find_long(split.long_name);
+
+            if (arg_char == '\0') {
+                // Use '-' for unknown long args
+                return std::unexpected(RawParseError{ParseError::UnknownArgument, '-', i, arg});
+            }
+        } else {
+            arg_char = split.short_name;
+        }
+
+        // Check if argument is known
+        const auto& slot = table.slot(arg_char);
+        if (slot.type == ValueType::None) {
+            return std::unexpected(RawParseError{ParseError::UnknownArgument, arg_char, i, arg});
+        }
+
+        // Check for duplicate
+        const auto bit = static_cast<unsigned char>(arg_char);
+        const bool repeated = seen_args.test(bit);
+        if (repeated && !is_list(slot.type)) {
+            return std::unexpected(RawParseError{ParseError::DuplicateArgument, arg_char, i, ""});
+        }
+        seen_args.set(bit);
+
+        // -x=value or --xxx=value format carries its own value
+        int value_index = i;
+        if (!split.has_equals) {
+            if (slot.type == ValueType::Bool && !slot.required) {
+                // Optional bool, presence means true
+                value = "true";
+            } else {
+                // Non-bool types and required bools need a value
+                if (i + 1 >= count) {
+                    return std::unexpected(RawParseError{
+                        ParseError::MissingValue,
+                        arg_char,
+                        i,
+                        slot.type == ValueType::Bool ? "required boolean needs explicit value" : ""
+                    });
+                }
+                value_index = ++i;
+                value = std::string_view(args[i]);
+            }
+        }
+
+        const std::expected<void, ParseError> stored = store(arg_char, slot, value, repeated);
+        if (!stored) {
+            return std::unexpected(RawParseError{stored.error(), arg_char, value_index, value});
+        }
+    }
+
+    // The command line takes precedence over the environment
+    if constexpr (requires { table.find_env(std::string_view{}); }) {
+        for (; env != nullptr && *env != nullptr; ++env) {
+            const std::string_view entry(*env);
+            const std::size_t equals = entry.find('=');
+            const char arg_char = equals == std::string_view::npos ? '\0' : table.find_env(entry.substr(0, equals));
+            const auto bit = static_cast<unsigned char>(arg_char);
+            if (arg_char == '\0' || seen_args.test(bit)) {
+                continue;
+            }
+            seen_args.set(bit);
+
+            const std::expected<void, ParseError> stored = store(arg_char, table.slot(arg_char), entry.substr(equals + 1), false);
+            if (!stored) {
+                return std::unexpected(RawParseError{stored.error(), arg_char, -1, entry});
+            }
+        }
+    }
+
+    // The config file only supplies options given in neither
+    std::bitset<256> in_file;
+    for (const FileEntry& entry : file) {
+        const auto bit = static_cast<unsigned char>(entry.key);
+        if (seen_args.test(bit)) {
+            continue;
+        }
+        const auto& slot = table.slot(entry.key);
+        const bool repeated = in_file.test(bit);
+        if (repeated && !is_list(slot.type)) {
+            return std::unexpected(RawParseError{ParseError::DuplicateArgument, entry.key, -1, entry.line});
+        }
+        in_file.set(bit);
+
+        const std::expected<void, ParseError> stored = store(entry.key, slot, entry.value, repeated);
+        if (!stored) {
+            return std::unexpected(RawParseError{stored.error(), entry.key, -1, entry.line});
+        }
+    }
+    seen_args |= in_file;
+
+    // Check all required arguments are present
+    const std::bitset<256> missing = table.required() & ~seen_args;
+    if (missing.any()) {
+        char first = '\0';
+        for (std::size_t bit = 0; bit < missing.size(); ++bit) {
+            if (missing.test(bit)) {
+                first = static_cast<char>(static_cast<unsigned char>(bit));
+                break;
+            }
+        }
+        return std::unexpected(RawParseError{ParseError::MissingRequiredArgument, first, -1, "", missing});
+    }
+
+    return {};
+}
+
+} // namespace detail
+
+class schema_builder;
+
+namespace detail {
+
+// Type a handle reads for an option whose default is a V: strings and
+// lists are read as views, like BorrowedArgValue
+template<typename V>
+struct handle_type {
+    using type = V;
+};
+template<typename V>
+    requires std::is_convertible_v<const V&, std::string_view>
+struct handle_type<V> {
+    using type = std::string_view;
+};
+template<>
+struct handle_type<std::vector<int>> {
+    using type = std::span<const int>;
+};
+template<>
+struct handle_type<std::vector<std::string>> {
+    using type = std::span<const std::string_view>;
+};
+template<typename Rep, typename Period>
+struct handle_type<std::chrono::duration<Rep, Period>> {
+    using type = std::chrono::nanoseconds;
+};
+
+template<typename V>
+using handle_type_t = typename handle_type<std::decay_t<V>>::type;
+
+template<typename T, typename Variant>
+struct is_alternative : std::false_type {};
+template<typename T, typename... Types>
+struct is_alternative<T, std::variant<Types...>> : std::bool_constant<(std::is_same_v<T, Types> || ...)> {};
+
+} // namespace detail
+
+// Typed handle to one option of a schema, returned by schema_builder::add().
+// Reading a result through it is a direct load of the option's slot whose
+// type is fixed at compile time, so there is no lookup or type check.
+template<typename T>
+class opt {
+    static_assert(detail::is_alternative<T, BorrowedArgValue>::value,
+                  "handles read BorrowedArgValue types (std::string_view for strings, spans for lists)");
+
+public:
+    using value_type = T;
+
+    constexpr char key() const noexcept { return key_; }
+
+private:
+    friend class schema_builder;
+
+    constexpr explicit opt(char key) noexcept : key_(key) {}
+
+    char key_;
+};
+
+// Caller-owned storage for parser::parse_into(). Values are kept densely
+// in option order and reset in place from the parser's default image, so
+// a buffer that is reused does not allocate once it has been sized.
+// String values are views into argv or the parser, which must outlive the
+// buffer's contents. List values are spans over storage kept per list
+// option in the buffer (or over the parser's defaults); a copy of the
+// buffer still views the original's lists.
+class ResultBuffer {
+public:
+    ResultBuffer() = default;
+
+    // Buffer whose storage comes from resource
+    explicit ResultBuffer(std::pmr::memory_resource* resource)
+        : values_(resource)
+        , int_lists_(resource)
+        , string_lists_(resource)
+    {
+    }
+
+    bool contains(char key) const noexcept { return table_ && table_->contains(key); }
+
+    // Subscript operator
+    const BorrowedArgValue& operator[](char key) const { return at(key); }
+    const BorrowedArgValue& at(char key) const {
+        if (!contains(key)) {
+            throw std::out_of_range("cppcliargs: unknown argument");
+        }
+        return values_[table_->slot(key).default_index];
+    }
+
+    // Template-based typed getter (use std::string_view for strings and
+    // std::span<const int> or std::span<const std::string_view> for lists)
+    template<typename T>
+    T get(char key) const {
+        return std::get<T>(at(key));
+    }
+
+    // Unchecked read through a handle of the schema that filled the buffer
+    // (checked by assert() in debug builds)
+    template<typename T>
+    T operator[](opt<T> handle) const noexcept {
+        assert(contains(handle.key()) && "handle of another schema");
+        const T* value = std::get_if<T>(&values_[table_->slot(handle.key()).default_index]);
+        assert(value != nullptr && "handle of another schema");
+        if (value == nullptr) {
+            std::unreachable();  // the handle's type is the option's
+        }
+        return *value;
+    }
+
+private:
+    friend class schema;
+
+    static_assert(std::is_trivially_copyable_v<BorrowedArgValue>,
+                  "the default image is restored with a plain copy");
+
+    // Restore the defaults of table, reusing the existing storage
+    void reset(const detail::OptionTable& table) {
+        table_ = &table;
+        values_.assign(table.defaults().begin(), table.defaults().end());
+        if (table.has_lists() && int_lists_.size() < values_.size()) {
+            int_lists_.resize(values_.size());
+            string_lists_.resize(values_.size());
+        }
+    }
+
+    // Append one occurrence of a list option; the first replaces the default
+    std::expected<void, ParseError> append_list(const detail::OptionSlot& slot, std::string_view value, bool repeated) {
+        const std::size_t index = slot.default_index;
+        if (slot.type == detail::ValueType::IntList) {
+            auto& list = int_lists_[index];
+            if (!repeated) {
+                list.clear();
+            }
+            auto appended = detail::append_list<int>(value, list);
+            values_[index] = std::span<const int>(list);
+            return appended;
+        }
+
+        auto& list = string_lists_[index];
+        if (!repeated) {
+            list.clear();
+        }
+        auto appended = detail::append_list<std::string_view>(value, list);
+        values_[index] = std::span<const std::string_view>(list);
+        return appended;
+    }
+
+    const detail::OptionTable* table_ = nullptr;
+    std::pmr::vector<BorrowedArgValue> values_;
+    // Items of list options by default_index, reused across parses
+    std::pmr::vector<std::pmr::vector<int>> int_lists_;
+    std::pmr::vector<std::pmr::vector<std::string_view>> string_lists_;
+};
+
+// Options bound to data members of Struct, for parser::parse_into(Struct&,
+// const bindings<Struct>&). Supported members are int, bool, std::string,
+// std::string_view (which views argv or the parser), std::int64_t,
+// std::uint64_t, double, ByteSize, std::chrono::nanoseconds, and for list
+// options std::vector<int>, std::vector<std::string> and
+// std::vector<std::string_view>. A std::span<int>, std::span<float> or
+// std::span<double> member bound to a string option receives the
+// comma-separated numbers in its elements (see parse_array()) and their
+// number in a std::size_t count member; the span keeps its extent, so a
+// struct reused across parses keeps its capacity.
+template<typename Struct>
+class bindings {
+public:
+    // Write option key into member; rebinding a key replaces the member
+    template<typename Member>
+    bindings& bind(char key, Member Struct::* member) {
+        static_assert(std::is_same_v<Member, int> || std::is_same_v<Member, bool> ||
+                      std::is_same_v<Member, std::string> || std::is_same_v<Member, std::string_view> ||
+                      std::is_same_v<Member, std::int64_t> || std::is_same_v<Member, std::uint64_t> ||
+                      std::is_same_v<Member, double> || std::is_same_v<Member, ByteSize> ||
+                      std::is_same_v<Member, std::chrono::nanoseconds> || std::is_same_v<Member, std::vector<int>> ||
+                      std::is_same_v<Member, std::vector<std::string>> ||
+                      std::is_same_v<Member, std::vector<std::string_view>>,
+                      "bound members must be int, bool, std::string, std::string_view, "
+                      "std::int64_t, std::uint64_t, double, ByteSize, std::chrono::nanoseconds, "
+                      "or a std::vector of int, std::string or std::string_view "
+                      "(bind a std::span together with a count member)");
+        return add(key, member, nullptr);
+    }
+
+    // Write the numbers of string option key into the elements of member
+    // and how many there are into count
+    template<typename T>
+    bindings& bind(char key, std::span<T> Struct::* member, std::size_t Struct::* count) {
+        static_assert(std::is_same_v<T, int> || std::is_same_v<T, float> || std::is_same_v<T, double>,
+                      "bound spans must be of int, float or double");
+        return add(key, member, count);
+    }
+
+    // Bound options in the order they were bound
+    template<typename Visitor>
+    void for_each_key(Visitor&& visitor) const {
+        for (const Entry& entry : entries_) {
+            visitor(entry.key);
+        }
+    }
+
+    // Store value in the member bound to key (a no-op for unbound keys);
+    // fails with TypeMismatch if the member cannot hold the value
+    std::expected<void, ParseError> assign(Struct& target, char key, const BorrowedArgValue& value) const {
+        const std::uint8_t index = index_[static_cast<unsigned char>(key)];
+        if (index == 0) {
+            return {};
+        }
+
+        const Entry& entry = entries_[index - 1];
+        return std::visit([&](auto member) -> std::expected<void, ParseError> {
+            using Member = std::remove_reference_t<decltype(target.*member)>;
+            using Item = detail::list_item_t<Member>;
+
+            if constexpr (!std::is_void_v<detail::array_item_t<Member>>) {
+                const auto* text = std::get_if<std::string_view>(&value);
+                if (!text) {
+                    return std::unexpected(ParseError::TypeMismatch);
+                }
+                auto written = parse_array(*text, target.*member);
+                if (!written) {
+                    return std::unexpected(written.error());
+                }
+                target.*entry.count = *written;
+            } else if constexpr (!std::is_void_v<Item>) {
+                using Items = std::span<const std::conditional_t<std::is_same_v<Item, int>, int, std::string_view>>;
+                const auto* items = std::get_if<Items>(&value);
+                if (!items) {
+                    return std::unexpected(ParseError::TypeMismatch);
+                }
+                (target.*member).assign(items->begin(), items->end());
+            } else {
+                using Stored = std::conditional_t<std::is_same_v<Member, std::string>, std::string_view, Member>;
+                const auto* typed = std::get_if<Stored>(&value);
+                if (!typed) {
+                    return std::unexpected(ParseError::TypeMismatch);
+                }
+                target.*member = Member(*typed);
+            }
+            return {};
+        }, entry.member);
+    }
+
+    // Append one occurrence of list option key (of type type) to the
+    // vector bound to it, replacing the default on the first occurrence.
+    // Unbound lists are only checked.
+    std::expected<void, ParseError> append(Struct& target, char key, detail::ValueType type,
+                                           std::string_view value, bool repeated) const {
+        const std::uint8_t index = index_[static_cast<unsigned char>(key)];
+        if (index == 0) {
+            detail::DiscardItems discard;
+            return type == detail::ValueType::IntList ? detail::append_list<int>(value, discard)
+                                                      : std::expected<void, ParseError>{};
+        }
+
+        return std::visit([&](auto member) -> std::expected<void, ParseError> {
+            using Member = std::remove_reference_t<decltype(target.*member)>;
+            using Item = detail::list_item_t<Member>;
+
+            if constexpr (std::is_void_v<Item> || !std::is_void_v<detail::array_item_t<Member>>) {
+                return std::unexpected(ParseError::TypeMismatch);
+            } else {
+                constexpr bool ints = std::is_same_v<Item, int>;
+                if (type != (ints ? detail::ValueType::IntList : detail::ValueType::StringList)) {
+                    return std::unexpected(ParseError::TypeMismatch);
+                }
+                if (!repeated) {
+                    (target.*member).clear();
+                }
+                return detail::append_list<std::conditional_t<ints, int, std::string_view>>(value, target.*member);
+            }
+        }, entries_[index - 1].member);
+    }
+
+private:
+    struct Entry {
+        char key;
+        std::variant<int Struct::*, bool Struct::*, std::string Struct::*, std::string_view Struct::*,
+                     std::int64_t Struct::*, std::uint64_t Struct::*, double Struct::*,
+                     ByteSize Struct::*, std::chrono::nanoseconds Struct::*,
+                     std::vector<int> Struct::*, std::vector<std::string> Struct::*,
+                     std::vector<std::string_view> Struct::*, std::span<int> Struct::*,
+                     std::span<float> Struct::*, std::span<double> Struct::*> member;
+        std::size_t Struct::* count;  // written items of a span member
+    };
+
+    template<typename Member>
+    bindings& add(char key, Member Struct::* member, std::size_t Struct::* count) {
+        std::uint8_t& index = index_[static_cast<unsigned char>(key)];
+        if (index == 0) {
+            entries_.push_back({key, member, count});
+            index = static_cast<std::uint8_t>(entries_.size());
+        } else {
+            entries_[index - 1].member = member;
+            entries_[index - 1].count = count;
+        }
+        return *this;
+    }
+
+    std::array<std::uint8_t, 256> index_{};
+    std::vector<Entry> entries_;
+};
+
+namespace detail {
+
+constexpr bool is_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+enum class TokenizeStatus { Done, Stopped, UnterminatedQuote };
+
+// Split text into whitespace-separated tokens in place, handing each to
+// token(std::string_view, bool quoted), which returns false to stop;
+// quoted is whether the token starts with a quote or an escape, so that
+// its first character is literal. '...' is taken literally; "..." allows
+// \" and \\ escapes; elsewhere a backslash escapes the next character.
+// Characters are only moved once a quote or escape has been removed from
+// the token, so text without them is not written.
+template<typename Token>
+TokenizeStatus tokenize_in_place(char* text, std::size_t size, Token&& token) {
+    std::size_t in = 0;
+    while (true) {
+        while (in < size && is_space(text[in])) {
+            ++in;
+        }
+        if (in == size) {
+            return TokenizeStatus::Done;
+        }
+
+        const std::size_t start = in;
+        const bool quoted = text[in] == '\'' || text[in] == '"' || (text[in] == '\\' && in + 1 < size);
+        std::size_t out = in;
+        auto keep = [&](std::size_t from) {
+            if (out != from) {
+                text[out] = text[from];
+            }
+            ++out;
+        };
+
+        while (in < size && !is_space(text[in])) {
+            const char c = text[in];
+            if (c == '\'') {
+                for (++in; in < size && text[in] != '\''; ++in) {
+                    keep(in);
+                }
+                if (in == size) {
+                    return TokenizeStatus::UnterminatedQuote;
+                }
+                ++in;
+            } else if (c == '"') {
+                for (++in; in < size && text[in] != '"'; ++in) {
+                    if (text[in] == '\\' && in + 1 < size && (text[in + 1] == '"' || text[in + 1] == '\\')) {
+                        ++in;
+                    }
+                    keep(in);
+                }
+                if (in == size) {
+                    return TokenizeStatus::UnterminatedQuote;
+                }
+                ++in;
+            } else if (c == '\\' && in + 1 < size) {
+                keep(in + 1);
+                in += 2;
+            } else {
+                keep(in++);
+            }
+        }
+
+        if (!token(std::string_view(text + start, out - start), quoted)) {
+            return TokenizeStatus::Stopped;
+        }
+    }
+}
+
+} // namespace detail
+
+// Expands @path arguments into the tokens of the response file at path,
+// e.g. "prog @build.rsp -v". Files are mapped and tokenized in place, so
+// the tokens are views into the mapping (or into the original arguments)
+// and stay valid until the next expand() or until this object is
+// destroyed. Response files may name further response files with an
+// unquoted @path ('@path' is kept as a token); paths are taken relative
+// to the working directory and a file that includes itself, directly or
+// not, is an error. An expander that is reused only allocates
+// when a command line has more tokens or files than any before it.
+class ResponseFiles {
+public:
+    // Expand args (args[0] is the program name, which is kept as is)
+    std::expected<std::span<const std::string_view>, ParseErrorInfo> expand(std::span<const char* const> args) {
+        tokens_.clear();
+        files_.clear();
+        open_.clear();
+
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            const std::string_view arg(args[i]);
+            if (i > 0 && arg.size() > 1 && arg.front() == '@') {
+                if (auto included = include(arg.substr(1)); !included) {
+                    return std::unexpected(std::move(included.error()));
+                }
+            } else {
+                tokens_.push_back(arg);
+            }
+        }
+        return tokens();
+    }
+
+    // Tokens of the last expand(), partial if it failed
+    std::span<const std::string_view> tokens() const noexcept {
+        return tokens_;
+    }
+
+private:
+    std::expected<void, ParseErrorInfo> include(std::string_view path) {
+        auto fail = [&](std::string_view reason) {
+            std::string detail(path);
+            detail += ": ";
+            detail += reason;
+            return std::unexpected(ParseErrorInfo{ParseError::ResponseFileError, '@', std::move(detail)});
+        };
+
+        path_.assign(path);  // NUL-terminated for the system
+        auto file = detail::MappedFile::open(path_);
+        if (!file) {
+            return fail(file.error());
+        }
+        if (std::ranges::find(open_, file->id()) != open_.end()) {
+            return fail("response file includes itself");
+        }
+
+        char* const text = file->data();
+        const std::size_t size = file->size();
+        open_.push_back(file->id());
+        files_.push_back(std::move(*file));
+
+        std::expected<void, ParseErrorInfo> nested;
+        const detail::TokenizeStatus status = detail::tokenize_in_place(text, size, [&](std::string_view token, bool quoted) {
+            if (!quoted && token.size() > 1 && token.front() == '@') {
+                nested = include(token.substr(1));
+                return nested.has_value();
+            }
+            tokens_.push_back(token);
+            return true;
+        });
+        if (!nested) {
+            return nested;
+        }
+        if (status == detail::TokenizeStatus::UnterminatedQuote) {
+            return fail("unterminated quote");
+        }
+
+        open_.pop_back();
+        return {};
+    }
+
+    std::vector<std::string_view> tokens_;
+    std::vector<detail::MappedFile> files_;
+    std::vector<detail::MappedFile::Id> open_;  // files being expanded, outermost first
+    std::string path_;
+};
+
+namespace detail {
+
+// Binary snapshot layout: a header, one entry per option, then the values,
+// each at an offset from the start that is a multiple of 8. Strings are
+// raw bytes, integer lists int arrays, string lists arrays of SnapshotSpan
+// and other values are stored as themselves. Byte order is the writer's;
+// a reader of the other order sees an unknown version.
+inline constexpr std::array<char, 8> snapshot_magic = {'c', 'l', 'i', 'a', 'r', 'g', 's', '\0'};
+inline constexpr std::uint32_t snapshot_version = 1;
+
+struct SnapshotHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t count;
+    std::uint64_t schema_hash;
+    std::uint64_t size;
+    std::array<std::uint8_t, 256> index;  // entry number + 1 by option character
+};
+
+struct SnapshotEntry {
+    ValueType type;
+    std::uint8_t reserved[3];
+    std::uint32_t count;  // bytes of a string, items of a list, else 1
+    std::uint64_t offset;
+};
+
+struct SnapshotSpan {
+    std::uint64_t offset;
+    std::uint64_t length;
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader> && sizeof(SnapshotHeader) == 288);
+static_assert(sizeof(SnapshotEntry) == 16 && sizeof(SnapshotSpan) == 16);
+
+// Bytes a value of type takes per item
+constexpr std::size_t snapshot_item_size(ValueType type) noexcept {
+    switch (type) {
+        case ValueType::Int: return sizeof(int);
+        case ValueType::Bool: return sizeof(bool);
+        case ValueType::String: return 1;
+        case ValueType::Int64: return sizeof(std::int64_t);
+        case ValueType::UInt64: return sizeof(std::uint64_t);
+        case ValueType::Double: return sizeof(double);
+        case ValueType::IntList: return sizeof(int);
+        case ValueType::StringList: return sizeof(SnapshotSpan);
+        case ValueType::Size: return sizeof(ByteSize);
+        case ValueType::Duration: return sizeof(std::chrono::nanoseconds);
+        case ValueType::None: break;
+    }
+    return 0;
+}
+
+// Type tag of a value type stored as itself, None for any other type
+template<typename T>
+constexpr ValueType scalar_type() noexcept {
+    if constexpr (std::is_same_v<T, int>) return ValueType::Int;
+    else if constexpr (std::is_same_v<T, bool>) return ValueType::Bool;
+    else if constexpr (std::is_same_v<T, std::int64_t>) return ValueType::Int64;
+    else if constexpr (std::is_same_v<T, std::uint64_t>) return ValueType::UInt64;
+    else if constexpr (std::is_same_v<T, double>) return ValueType::Double;
+    else if constexpr (std::is_same_v<T, ByteSize>) return ValueType::Size;
+    else if constexpr (std::is_same_v<T, std::chrono::nanoseconds>) return ValueType::Duration;
+    else return ValueType::None;
+}
+
+// Item count of a snapshot entry, which the format stores in 32 bits
+inline std::uint32_t snapshot_count(std::size_t count) {
+    if (count > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("cppcliargs: value too large for a snapshot");
+    }
+    return static_cast<std::uint32_t>(count);
+}
+
+// Write the values of result (an ArgMap-like map) as a snapshot
+template<typename Map>
+std::string write_snapshot(const Map& result, std::uint64_t schema_hash) {
+    SnapshotHeader header{
+        .magic = snapshot_magic,
+        .version = snapshot_version,
+        .count = static_cast<std::uint32_t>(result.size()),
+        .schema_hash = schema_hash,
+        .size = 0,
+        .index = {}
+    };
+    std::vector<SnapshotEntry> entries;
+    entries.reserve(result.size());
+
+    std::string blob(sizeof(SnapshotHeader) + result.size() * sizeof(SnapshotEntry), '\0');
+    auto append = [&](const void* data, std::size_t size) {
+        blob.resize((blob.size() + 7) & ~std::size_t{7});
+        const std::uint64_t offset = blob.size();
+        blob.append(static_cast<const char*>(data), size);
+        return offset;
+    };
+
+    for (const auto& [key, value] : result) {
+        SnapshotEntry entry{.type = value_type_of(value), .reserved = {}, .count = 1, .offset = 0};
+        std::visit([&](const auto& v) {
+            using T = std::decay_t<decltype(v)>;
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                entry.offset = append(&v, sizeof(v));
+            } else if constexpr (std::is_same_v<typename T::value_type, char>) {
+                entry.count = snapshot_count(v.size());
+                entry.offset = append(v.data(), v.size());
+            } else if constexpr (std::is_same_v<typename T::value_type, int>) {
+                entry.count = snapshot_count(v.size());
+                entry.offset = append(v.data(), v.size() * sizeof(int));
+            } else {
+                std::vector<SnapshotSpan> spans;
+                spans.reserve(v.size());
+                for (const auto& item : v) {
+                    spans.push_back({append(item.data(), item.size()), item.size()});
+                }
+                entry.count = snapshot_count(spans.size());
+                entry.offset = append(spans.data(), spans.size() * sizeof(SnapshotSpan));
+            }
+        }, value);
+        entries.push_back(entry);
+        header.index[static_cast<unsigned char>(key)] = static_cast<std::uint8_t>(entries.size());
+    }
+
+    blob.resize((blob.size() + 7) & ~std::size_t{7});
+    header.size = blob.size();
+    std::memcpy(blob.data(), &header, sizeof(header));
+    std::memcpy(blob.data() + sizeof(header), entries.data(), entries.size() * sizeof(SnapshotEntry));
+    return blob;
+}
+
+} // namespace detail
+
+// Items of a string list in a Snapshot, viewed in place
+class SnapshotStrings {
+public:
+    class iterator {
+    public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const SnapshotStrings* list, std::size_t index) : list_(list), index_(index) {}
+
+        std::string_view operator*() const { return (*list_)[index_]; }
+        iterator& operator++() { ++index_; return *this; }
+        iterator operator++(int) { iterator old = *this; ++index_; return old; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const SnapshotStrings* list_ = nullptr;
+        std::size_t index_ = 0;
+    };
+
+    SnapshotStrings() = default;
+    SnapshotStrings(const char* base, const char* spans, std::size_t size) noexcept
+        : base_(base), spans_(spans), size_(size) {}
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    std::string_view operator[](std::size_t i) const noexcept {
+        detail::SnapshotSpan span;
+        std::memcpy(&span, spans_ + i * sizeof(span), sizeof(span));
+        return std::string_view(base_ + span.offset, span.length);
+    }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size_); }
+
+private:
+    const char* base_ = nullptr;
+    const char* spans_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// A parse result saved by parser::save_snapshot() and read back in place:
+// getters read the loaded bytes directly, so opening one costs a read
+// and a bounds check of each entry, not a parse. open() reads the file
+// into memory of its own, so later changes to the file do not affect it;
+// copies share that memory. Strings and lists are views into it, valid
+// while any copy lives.
+class Snapshot {
+public:
+    // Read the snapshot at path, which must have been saved with the same
+    // schema (see parser::schema_hash())
+    static std::expected<Snapshot, ParseErrorInfo> open(const std::string& path, std::uint64_t schema_hash) {
+        // Words rather than chars, so the copy is 8-byte aligned like the file
+        std::shared_ptr<std::uint64_t[]> storage;
+        auto read = detail::read_file(path, [&](std::size_t size) {
+            storage.reset(new std::uint64_t[size / 8 + 1]);
+            return reinterpret_cast<char*>(storage.get());
+        });
+        if (!read) {
+            return std::unexpected(ParseErrorInfo{ParseError::SnapshotError, '-', path + ": " + read.error()});
+        }
+        auto snapshot = view(std::span<const char>(reinterpret_cast<const char*>(storage.get()), *read), schema_hash);
+        if (!snapshot) {
+            snapshot.error().detail.insert(0, path + ": ");
+        } else {
+            snapshot->storage_ = std::move(storage);
+        }
+        return snapshot;
+    }
+
+    // Read a snapshot held by the caller; bytes must be 8-byte aligned and
+    // outlive the Snapshot
+    static std::expected<Snapshot, ParseErrorInfo> view(std::span<const char> bytes, std::uint64_t schema_hash) {
+        auto fail = [](const char* reason) {
+            return std::unexpected(ParseErrorInfo{ParseError::SnapshotError, '-', reason});
+        };
+
+        detail::SnapshotHeader header;
+        if (bytes.size() < sizeof(header) || reinterpret_cast<std::uintptr_t>(bytes.data()) % 8 != 0) {
+            return fail("too short or misaligned");
+        }
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != detail::snapshot_magic) {
+            return fail("not a snapshot");
+        }
+        if (header.version != detail::snapshot_version) {
+            return fail("unsupported version or byte order");
+        }
+        if (header.schema_hash != schema_hash) {
+            return fail("saved with a different schema");
+        }
+        if (header.size != bytes.size() || header.count > 256 ||
+            sizeof(header) + header.count * sizeof(detail::SnapshotEntry) > bytes.size()) {
+            return fail("truncated or corrupt");
+        }
+
+        Snapshot snapshot;
+        snapshot.data_ = bytes.data();
+        snapshot.size_ = bytes.size();
+        snapshot.index_ = header.index;
+        for (std::uint8_t number : header.index) {
+            if (number > header.count) {
+                return fail("truncated or corrupt");
+            }
+        }
+        for (std::uint32_t i = 0; i < header.count; ++i) {
+            if (!snapshot.valid(snapshot.entry_at(i))) {
+                return fail("truncated or corrupt");
+            }
+        }
+        return snapshot;
+    }
+
+    std::uint64_t schema_hash() const noexcept {
+        detail::SnapshotHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        return header.schema_hash;
+    }
+
+    bool contains(char key) const noexcept {
+        return index_[static_cast<unsigned char>(key)] != 0;
+    }
+
+    // Typed getter like ParseResultValue's, using std::string_view for
+    // strings, std::span<const int> for integer lists and SnapshotStrings
+    // for string lists. Throws std::out_of_range for an unknown option and
+    // std::bad_variant_access for the wrong type.
+    template<typename T>
+    T get(char key) const {
+        if (!contains(key)) {
+            throw std::out_of_range("cppcliargs: unknown argument");
+        }
+        const detail::SnapshotEntry entry = entry_at(index_[static_cast<unsigned char>(key)] - 1u);
+        const char* value = data_ + entry.offset;
+
+        constexpr detail::ValueType type =
+            std::is_same_v<T, std::string_view> ? detail::ValueType::String :
+            std::is_same_v<T, std::span<const int>> ? detail::ValueType::IntList :
+            std::is_same_v<T, SnapshotStrings> ? detail::ValueType::StringList :
+            detail::scalar_type<T>();
+        static_assert(type != detail::ValueType::None, "no option holds values of this type");
+        if (entry.type != type) {
+            throw std::bad_variant_access();
+        }
+
+        if constexpr (std::is_same_v<T, std::string_view>) {
+            return std::string_view(value, entry.count);
+        } else if constexpr (std::is_same_v<T, std::span<const int>>) {
+            return std::span<const int>(reinterpret_cast<const int*>(value), entry.count);
+        } else if constexpr (std::is_same_v<T, SnapshotStrings>) {
+            return SnapshotStrings(data_, value, entry.count);
+        } else {
+            T result;
+            std::memcpy(&result, value, sizeof(T));
+            return result;
+        }
+    }
+
+private:
+    detail::SnapshotEntry entry_at(std::size_t i) const noexcept {
+        detail::SnapshotEntry entry;
+        std::memcpy(&entry, data_ + sizeof(detail::SnapshotHeader) + i * sizeof(entry), sizeof(entry));
+        return entry;
+    }
+
+    bool valid(const detail::SnapshotEntry& entry) const noexcept {
+        const std::size_t item = detail::snapshot_item_size(entry.type);
+        if (item == 0 || entry.offset % 8 != 0 || entry.offset > size_ ||
+            entry.count > (size_ - entry.offset) / item) {
+            return false;
+        }
+        // Any other value is one item, which the bounds check above only
+        // covers when count says so
+        const bool sized = entry.type == detail::ValueType::String || detail::is_list(entry.type);
+        if (!sized && entry.count != 1) {
+            return false;
+        }
+        if (entry.type == detail::ValueType::Bool) {
+            return static_cast<unsigned char>(data_[entry.offset]) <= 1;
+        }
+        if (entry.type == detail::ValueType::StringList) {
+            for (std::size_t i = 0; i < entry.count; ++i) {
+                detail::SnapshotSpan span;
+                std::memcpy(&span, data_ + entry.offset + i * sizeof(span), sizeof(span));
+                if (span.offset > size_ || span.length > size_ - span.offset) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::shared_ptr<const std::uint64_t[]> storage_;
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::array<std::uint8_t, 256> index_{};
+};
+
+// One command line for parser::parse_batch(): its tokens, starting with
+// the program name
+using CommandLine = std::span<const std::string_view>;
+
+// Receives the outcome of every command line of parser::parse_batch(), in
+// input order and one call at a time, though not always on the same
+// thread. index is the command line's position in the batch; string
+// values of result view its tokens.
+class ResultSink {
+public:
+    virtual ~ResultSink() = default;
+    virtual void consume(std::size_t index, const ParseStatus& status, const ResultBuffer& result) = 0;
+};
+
+// Result of parser::parse_borrowed(): a ResultBuffer owned by the caller
+using BorrowedParseResultValue = ResultBuffer;
+using BorrowedParseResult = std::expected<BorrowedParseResultValue, ParseErrorInfo>;
+
+// Result of schema::parse(): the values or why they could not be parsed,
+// and whether -h (or --help) was given, which is reported either way
+struct ParseOutcome {
+    ParseResult result;
+    bool help_requested = false;
+};
+
+// Options compiled once from a Config. A schema is immutable: every
+// member function is const and free of side effects, so one schema can
+// parse any number of command lines on any number of threads at once.
+class schema {
+public:
+    friend class options_snapshot;
+    friend class published_options;
+    friend class config_watcher;
+
+    explicit schema(const Config& config)
+        : table_(config)
+        , file_(load_config_file(config.config_file, std::pmr::get_default_resource()))
+    {
+    }
+
+    // The option table is allocated from the memory resource of config.defaults
+    explicit schema(const pmr::Config& config)
+        : table_(config, config.defaults.get_allocator().resource())
+        , file_(load_config_file(std::string(config.config_file), config.defaults.get_allocator().resource()))
+    {
+    }
+
+    // Parse a command line (args[0] is the program name). Help is not
+    // printed; check help_requested in the outcome and print
+    // generate_help().
+    ParseOutcome parse(std::span<const char* const> args) const {
+        return ParseOutcome{parse_owned(ArgMap{}, args, file_.get()), help_requested(args)};
+    }
+
+    // Same for tokens such as those of ResponseFiles::expand()
+    ParseOutcome parse(std::span<const std::string_view> args) const {
+        return ParseOutcome{parse_owned(ArgMap{}, args, file_.get()), help_requested(args)};
+    }
+
+    // Whether args asks for help with -h, or with --help when that is the
+    // long name of 'h'
+    template<typename Args>
+    bool help_requested(const Args& args) const {
+        const bool long_help = table_.long_name('h') == "help";
+        for (std::size_t i = 1; i < std::ranges::size(args); ++i) {
+            const std::string_view arg(args[i]);
+            if (arg == "-h" || (long_help && arg == "--help")) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Parse into a caller-owned buffer that can be reused across parses.
+    // String values are views into args (string defaults are views into
+    // this schema), so both must outlive the buffer's contents. On error
+    // the buffer holds a partial result.
+    ParseStatus parse_into(ResultBuffer& buffer, std::span<const char* const> args) const {
+        return fill_buffer(buffer, args, true);
+    }
+
+    // Same for tokens such as those of ResponseFiles::expand()
+    ParseStatus parse_into(ResultBuffer& buffer, std::span<const std::string_view> args) const {
+        return fill_buffer(buffer, args, true);
+    }
+
+    // Parse straight into the members of target that options are bound to.
+    // Bound options that are not given receive their defaults; options
+    // that are not bound are validated but not stored.
+    template<typename Struct>
+    ParseStatus parse_into(Struct& target, const bindings<Struct>& bound, std::span<const char* const> args) const {
+        return fill_bound(target, bound, args);
+    }
+
+    // Same for tokens such as those of ResponseFiles::expand()
+    template<typename Struct>
+    ParseStatus parse_into(Struct& target, const bindings<Struct>& bound, std::span<const std::string_view> args) const {
+        return fill_bound(target, bound, args);
+    }
+
+    // Parse newline-delimited command lines read from in, each split with
+    // the quoting rules of response files and starting with a program
+    // name. For every non-blank record this calls
+    // callback(record, status, result), where record is the 1-based line
+    // number and result is a ResultBuffer reused for all records whose
+    // strings view the read buffer until the callback returns. A callback
+    // returning bool stops the stream by returning false. Returns the
+    // number of records parsed. Each record stands alone: environment
+    // variables and the config file are not applied. Records are handed
+    // on as soon as they arrive: only what in has buffered is read
+    // without waiting, so a pipe is not read ahead of its writer.
+    template<typename Callback>
+    std::expected<std::size_t, ParseErrorInfo> parse_stream(std::istream& in, Callback&& callback) const {
+        return parse_records([&](char* data, std::size_t size) -> std::ptrdiff_t {
+            const std::streamsize buffered = in.readsome(data, static_cast<std::streamsize>(size));
+            if (buffered > 0) {
+                return static_cast<std::ptrdiff_t>(buffered);
+            }
+            // Nothing buffered: wait for one more character, or the end
+            in.read(data, 1);
+            return in.bad() ? -1 : static_cast<std::ptrdiff_t>(in.gcount());
+        }, std::forward<Callback>(callback));
+    }
+
+#ifdef CPPCLIARGS_MMAP
+    // Same for records read from a file descriptor, e.g. STDIN_FILENO
+    template<typename Callback>
+    std::expected<std::size_t, ParseErrorInfo> parse_stream(int fd, Callback&& callback) const {
+        return parse_records([&](char* data, std::size_t size) -> std::ptrdiff_t {
+            while (true) {
+                const ::ssize_t count = ::read(fd, data, size);
+                if (count >= 0 || errno != EINTR) {
+                    return count;
+                }
+            }
+        }, std::forward<Callback>(callback));
+    }
+#endif
+
+    // Parse many command lines on threads workers (0 for one per hardware
+    // thread). Workers take chunks of consecutive lines in order from a
+    // shared counter, parse them into their own reused buffers and hand
+    // them to sink in input order. An exception from sink stops the batch
+    // and is rethrown here once the workers have finished. Like
+    // parse_stream(), every line stands alone: environment variables and
+    // the config file are not applied.
+    void parse_batch(std::span<const CommandLine> lines, ResultSink& sink, unsigned threads = 0) const {
+        constexpr std::size_t chunk_size = 256;
+        const std::size_t chunks = (lines.size() + chunk_size - 1) / chunk_size;
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(chunks, 1)));
+
+        std::atomic<std::size_t> next_chunk{0};
+        std::atomic<std::size_t> delivered{0};  // chunks handed to sink
+        std::atomic<bool> stopped{false};
+        std::exception_ptr failure;
+
+        auto work = [&] {
+            std::vector<ResultBuffer> results(chunk_size);
+            std::vector<ParseStatus> statuses(chunk_size);
+            for (std::size_t chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+                 chunk < chunks && !stopped.load(std::memory_order_relaxed);
+                 chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+                const std::size_t first = chunk * chunk_size;
+                const std::size_t count = std::min(chunk_size, lines.size() - first);
+                for (std::size_t i = 0; i < count; ++i) {
+                    statuses[i] = fill_buffer(results[i], lines[first + i], false);
+                }
+
+                // Chunks are taken in order, so the wait for earlier ones is short
+                for (std::size_t done = delivered.load(std::memory_order_acquire); done != chunk;
+                     done = delivered.load(std::memory_order_acquire)) {
+                    if (stopped.load(std::memory_order_relaxed)) {
+                        return;
+                    }
+                    delivered.wait(done, std::memory_order_acquire);
+                }
+                if (!stopped.load(std::memory_order_relaxed)) {
+                    try {
+                        for (std::size_t i = 0; i < count; ++i) {
+                            sink.consume(first + i, statuses[i], results[i]);
+                        }
+                    } catch (...) {
+                        failure = std::current_exception();
+                        stopped.store(true, std::memory_order_relaxed);
+                    }
+                }
+                delivered.store(chunk + 1, std::memory_order_release);
+                delivered.notify_all();
+            }
+        };
+
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(threads - 1);
+            for (unsigned i = 1; i < threads; ++i) {
+                workers.emplace_back(work);
+            }
+            work();
+        }
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    // Hash of this schema's options, saved in snapshots to detect a
+    // snapshot written by a different build or configuration
+    std::uint64_t schema_hash() const noexcept {
+        return table_.schema_hash();
+    }
+
+    // Serialize a result of this schema into a position-independent blob
+    // for Snapshot (write it to a file and load it with load_snapshot()).
+    // Throws std::length_error for a string of 4 GiB or more, or a list
+    // of as many items.
+    template<typename Map>
+    std::string save_snapshot(const basic_parse_result_value<Map>& result) const {
+        return detail::write_snapshot(result.values(), schema_hash());
+    }
+
+    // Load a snapshot saved with save_snapshot() with the same schema
+    std::expected<Snapshot, ParseErrorInfo> load_snapshot(const std::string& path) const {
+        return Snapshot::open(path, schema_hash());
+    }
+
+    // Generate help text
+    std::string generate_help(const std::string& program_name = "program") const {
+        std::string result;
+        result += "Usage: " + program_name + " [OPTIONS]\n\n";
+        result += "Options:\n";
+        
+        // Generate help line for each argument
+        for (char arg : table_.options()) {
+            detail::append_help_prefix(result, arg, table_.long_name(arg));
+
+            std::visit([&](const auto& default_val) {
+                using T = std::decay_t<decltype(default_val)>;
+
+                // Add help text if present, otherwise show type
+                if (std::string_view help = table_.help(arg); !help.empty()) {
+                    result += help;
+                } else {
+                    result += detail::type_label<T>();
+                }
+
+                detail::append_help_default(result, default_val, table_.slot(arg).required);
+            }, table_.default_value(arg));
+            
+            result += "\n";
+        }
+        
+        return result;
+    }
+
+protected:
+    // parse_into() for a ResultBuffer over args of any token type, with
+    // the environment and config file layers if layered
+    template<typename Args>
+    ParseStatus fill_buffer(ResultBuffer& buffer, const Args& args, bool layered) const {
+        buffer.reset(table_);
+
+        return parse_tokens(args, layered ? file_.get() : nullptr, layered ? environment() : nullptr,
+            [&](char, const detail::OptionSlot& slot, std::string_view value, bool repeated) -> std::expected<void, ParseError> {
+                if (detail::is_list(slot.type)) {
+                    return buffer.append_list(slot, value, repeated);
+                }
+                auto converted = detail::convert_borrowed(slot.type, value);
+                if (!converted) {
+                    return std::unexpected(converted.error());
+                }
+                buffer.values_[slot.default_index] = *converted;
+                return {};
+            });
+    }
+
+    // parse_into() for bound members over args of any token type
+    template<typename Struct, typename Args>
+    ParseStatus fill_bound(Struct& target, const bindings<Struct>& bound, const Args& args) const {
+        ParseStatus status;
+        bound.for_each_key([&](char key) {
+            if (status && !table_.contains(key)) {
+                status = std::unexpected(ParseErrorInfo{ParseError::UnknownArgument, key, "bound option is not declared"});
+            }
+        });
+        if (!status) {
+            return status;
+        }
+
+        std::bitset<256> given;
+        status = parse_tokens(args, file_.get(), environment(),
+            [&](char arg_char, const detail::OptionSlot& slot, std::string_view value, bool repeated) -> std::expected<void, ParseError> {
+                given.set(static_cast<unsigned char>(arg_char));
+                if (detail::is_list(slot.type)) {
+                    return bound.append(target, arg_char, slot.type, value, repeated);
+                }
+                auto converted = detail::convert_borrowed(slot.type, value);
+                if (!converted) {
+                    return std::unexpected(converted.error());
+                }
+                return bound.assign(target, arg_char, *converted);
+            });
+        if (!status) {
+            return status;
+        }
+
+        // Defaults go in afterwards so that each member is written once
+        bound.for_each_key([&](char key) {
+            if (!status || given.test(static_cast<unsigned char>(key))) {
+                return;
+            }
+            if (auto assigned = bound.assign(target, key, table_.default_value(key)); !assigned) {
+                status = std::unexpected(ParseErrorInfo{assigned.error(), key, "bound member does not match the option type"});
+            }
+        });
+        return status;
+    }
+
+    // Parse args into result (an empty ArgMap-like map), with the entries
+    // of file as the config file layer
+    template<typename Map, typename Args>
+    std::expected<basic_parse_result_value<Map>, ParseErrorInfo> parse_owned(Map result, const Args& args,
+                                                                             const detail::ConfigFileLayer* file) const {
+        using Value = typename Map::mapped_type;
+        const auto alloc = result.get_allocator();
+
+        for (char key : table_.options()) {
+            result.emplace(key, detail::own_value<Value>(table_.default_value(key), alloc));
+        }
+
+        auto parsed = parse_tokens(args, file, environment(),
+            [&](char arg_char, const detail::OptionSlot& slot, std::string_view value, bool repeated) -> std::expected<void, ParseError> {
+                if (slot.type == detail::ValueType::IntList) {
+                    using IntList = detail::alternative_t<Value, detail::ValueType::IntList>;
+                    return detail::append_list<int>(value, list_of<IntList>(result[arg_char], repeated));
+                } else if (slot.type == detail::ValueType::StringList) {
+                    using StringList = detail::alternative_t<Value, detail::ValueType::StringList>;
+                    return detail::append_list<std::string_view>(value, list_of<StringList>(result[arg_char], repeated));
+                }
+                auto converted = detail::convert_borrowed(slot.type, value);
+                if (!converted) {
+                    return std::unexpected(converted.error());
+                }
+                result[arg_char] = detail::own_value<Value>(*converted, alloc);
+                return {};
+            });
+        if (!parsed) {
+            return std::unexpected(std::move(parsed.error()));
+        }
+
+        return basic_parse_result_value<Map>(std::move(result));
+    }
+
+    // The List alternative of value, emptied on an option's first occurrence
+    template<typename List, typename Value>
+    static List& list_of(Value& value, bool repeated) {
+        List& list = std::get<List>(value);
+        if (!repeated) {
+            list.clear();
+        }
+        return list;
+    }
+
+    // parse_stream() over read(data, size), which returns the bytes read,
+    // 0 at the end of the input or -1 on failure
+    template<typename Read, typename Callback>
+    std::expected<std::size_t, ParseErrorInfo> parse_records(Read&& read, Callback&& callback) const {
+        std::vector<char> data(64 * 1024);
+        std::vector<std::string_view> tokens;
+        ResultBuffer result;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        std::size_t line = 0;
+        std::size_t records = 0;
+        bool at_end = false;
+
+        while (begin < end || !at_end) {
+            char* const record = data.data() + begin;
+            char* newline = static_cast<char*>(std::memchr(record, '\n', end - begin));
+            if (newline == nullptr && !at_end) {
+                // Move the partial record to the front and read more,
+                // growing the buffer for records longer than it
+                std::memmove(data.data(), record, end - begin);
+                end -= begin;
+                begin = 0;
+                if (end == data.size()) {
+                    data.resize(2 * data.size());
+                }
+                const std::ptrdiff_t count = read(data.data() + end, data.size() - end);
+                if (count < 0) {
+                    return std::unexpected(ParseErrorInfo{ParseError::InputError, '-', "record " + std::to_string(line + 1)});
+                }
+                at_end = count == 0;
+                end += static_cast<std::size_t>(count);
+                continue;
+            }
+            const std::size_t length = newline != nullptr ? static_cast<std::size_t>(newline - record) : end - begin;
+            begin += length + (newline != nullptr ? 1 : 0);
+            ++line;
+
+            tokens.clear();
+            const detail::TokenizeStatus split = detail::tokenize_in_place(record, length, [&](std::string_view token, bool) {
+                tokens.push_back(token);
+                return true;
+            });
+            if (tokens.empty() && split == detail::TokenizeStatus::Done) {
+                continue;
+            }
+            ++records;
+
+            const ParseStatus status = split == detail::TokenizeStatus::UnterminatedQuote
+                ? ParseStatus(std::unexpected(ParseErrorInfo{ParseError::InvalidArguments, '-', "unterminated quote"}))
+                : fill_buffer(result, tokens, false);
+            if constexpr (std::is_same_v<std::invoke_result_t<Callback&, std::size_t, const ParseStatus&, const ResultBuffer&>, bool>) {
+                if (!callback(line, status, std::as_const(result))) {
+                    break;
+                }
+            } else {
+                callback(line, status, std::as_const(result));
+            }
+        }
+        return records;
+    }
+
+    // Walk the command line once, handing each option's raw value to
+    // store(arg_char, slot, value, repeated); file is the config file
+    // layer (file_, or a reloaded one) and env the environment, if any
+    template<typename Args, typename Store>
+    ParseStatus parse_tokens(const Args& args, const detail::ConfigFileLayer* file, const char* const* env,
+                             Store&& store) const {
+        if (file && file->error()) {
+            return std::unexpected(*file->error());
+        }
+        auto walked = detail::walk_arguments(table_, args, std::forward<Store>(store), env,
+                                             file ? file->entries() : std::span<const detail::FileEntry>{});
+        if (walked) {
+            return {};
+        }
+
+        const detail::RawParseError& raw = walked.error();
+        if (raw.error == ParseError::MissingRequiredArgument) {
+            return std::unexpected(detail::missing_required_error(raw.missing, [&](char key) {
+                return table_.long_name(key);
+            }));
+        }
+        return std::unexpected(ParseErrorInfo{raw.error, raw.argument, std::string(raw.detail)});
+    }
+
+    // The environment layer, if any option reads one
+    const char* const* environment() const noexcept {
+        return table_.has_env() ? detail::environment() : nullptr;
+    }
+
+    // Read and split the config file once, if there is one
+    std::shared_ptr<const detail::ConfigFileLayer> load_config_file(const std::string& path,
+                                                                    std::pmr::memory_resource* resource) const {
+        if (path.empty()) {
+            return nullptr;
+        }
+        return std::make_shared<const detail::ConfigFileLayer>(table_, path, resource);
+    }
+
+    // Compiled options, including the implicit -h
+    detail::OptionTable table_;
+
+    // Entries of Config::config_file; shared between copies so that
+    // string values viewing the file's text stay valid
+    std::shared_ptr<const detail::ConfigFileLayer> file_;
+};
+
+// Registers options one at a time, handing out a typed handle for each,
+// and compiles them into a schema (or a Config for a parser)
+class schema_builder {
+public:
+    // Add an option with its default, which also fixes its type; the
+    // handle reads it as that type (string_view for strings, spans for
+    // lists). A string default of any string type is stored as a copy.
+    template<typename V>
+    opt<detail::handle_type_t<V>> add(char key, V default_value, std::string long_name = {}, std::string help = {}) {
+        ArgValue value;
+        if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+            value = std::string(std::string_view(default_value));
+        } else {
+            value = std::move(default_value);
+        }
+        if (!config_.defaults.emplace(key, std::move(value)).second) {
+            throw std::invalid_argument("cppcliargs: option added twice");
+        }
+        if (!long_name.empty()) {
+            config_.long_names.emplace(key, std::move(long_name));
+        }
+        if (!help.empty()) {
+            config_.help.emplace(key, std::move(help));
+        }
+        return opt<detail::handle_type_t<V>>(key);
+    }
+
+    // Same for an option that must be given
+    template<typename V>
+    opt<detail::handle_type_t<V>> add_required(char key, V default_value, std::string long_name = {}, std::string help = {}) {
+        auto handle = add(key, std::move(default_value), std::move(long_name), std::move(help));
+        config_.required.insert(key);
+        return handle;
+    }
+
+    // Options added so far, e.g. to construct a parser for main()
+    const Config& config() const noexcept { return config_; }
+
+    schema build() const {
+        return schema(config_);
+    }
+
+private:
+    Config config_;
+};
+
+// Immutable copy of a parse result laid out like a ResultBuffer, so that
+// handles read it with one indexed load. Strings and lists view the
+// snapshot's own copy of the result; defaults view the schema, which
+// must outlive the snapshot.
+class options_snapshot {
+public:
+    // Snapshot of result, which must come from schema (keys the schema
+    // does not declare are ignored; a value whose type differs from its
+    // option's throws std::invalid_argument)
+    options_snapshot(const schema& schema, ParseResultValue result)
+        : table_(&schema.table_)
+        , result_(std::move(result))
+        , values_(table_->defaults().begin(), table_->defaults().end())
+    {
+        for (const auto& [key, value] : result_) {
+            if (!table_->contains(key)) {
+                continue;
+            }
+            const detail::OptionSlot& slot = table_->slot(key);
+            if (detail::value_type_of(value) != slot.type) {
+                throw std::invalid_argument("cppcliargs: result does not match the schema");
+            }
+            values_[slot.default_index] = std::visit([&](const auto& v) -> BorrowedArgValue {
+                using T = std::decay_t<decltype(v)>;
+                if constexpr (std::is_same_v<T, std::string>) {
+                    return std::string_view(v);
+                } else if constexpr (std::is_same_v<T, std::vector<int>>) {
+                    return std::span<const int>(v);
+                } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+                    auto& list = string_lists_.emplace_back(v.begin(), v.end());
+                    return std::span<const std::string_view>(list);
+                } else {
+                    return v;
+                }
+            }, value);
+        }
+    }
+
+    options_snapshot(const options_snapshot&) = delete;
+    options_snapshot& operator=(const options_snapshot&) = delete;
+
+    bool contains(char key) const noexcept { return table_->contains(key); }
+
+    // Values as a ResultBuffer holds them (string_view for strings, spans for lists)
+    const BorrowedArgValue& operator[](char key) const { return at(key); }
+    const BorrowedArgValue& at(char key) const {
+        if (!contains(key)) {
+            throw std::out_of_range("cppcliargs: unknown argument");
+        }
+        return values_[table_->slot(key).default_index];
+    }
+
+    template<typename T>
+    T get(char key) const {
+        return std::get<T>(at(key));
+    }
+
+    // Unchecked read through a handle of the snapshot's schema (checked
+    // by assert() in debug builds)
+    template<typename T>
+    T operator[](opt<T> handle) const noexcept {
+        assert(contains(handle.key()) && "handle of another schema");
+        const T* value = std::get_if<T>(&values_[table_->slot(handle.key()).default_index]);
+        assert(value != nullptr && "handle of another schema");
+        if (value == nullptr) {
+            std::unreachable();  // the handle's type is the option's
+        }
+        return *value;
+    }
+
+    // The owned result the snapshot was made from
+    const ParseResultValue& result() const noexcept { return result_; }
+
+private:
+    const detail::OptionTable* table_;
+    ParseResultValue result_;
+    std::vector<BorrowedArgValue> values_;
+    // Views of the string list options; a deque keeps each list in place
+    std::deque<std::vector<std::string_view>> string_lists_;
+};
+
+// The current options of a program, published to any number of reader
+// threads. Each thread reads through its own reader, for which reading is
+// one acquire load of the current snapshot and never blocks. publish()
+// and update() swap in a new snapshot, e.g. one parsed again on SIGHUP,
+// without waiting for readers, and retire the one replaced. Retired
+// snapshots are freed by quiescent-state-based reclamation: a reader
+// calls quiescent() whenever it holds no snapshot it read before (say
+// between two requests), and a snapshot is freed once every registered
+// reader has done so since it was retired. Publishing frees what it can,
+// as does reclaim(). A reader that never calls quiescent() keeps every
+// later snapshot alive until it is destroyed.
+class published_options {
+    // A reader's last quiescent state: the publish epoch it had seen then
+    struct ReaderSlot {
+        alignas(64) std::atomic<std::uint64_t> seen{0};
+        bool in_use = false;  // guarded by writer_
+    };
+
+public:
+    // One thread's registration with a publisher, which must outlive it
+    class reader {
+    public:
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+
+        ~reader() {
+            const std::lock_guard lock(publisher_.writer_);
+            slot_.in_use = false;
+            publisher_.reclaim_retired();
+        }
+
+        // The snapshot published last, valid until this reader next calls
+        // quiescent(); take it once per unit of work so that all options
+        // come from the same snapshot
+        const options_snapshot& current() const noexcept {
+            return *publisher_.current_.load(std::memory_order_acquire);
+        }
+
+        // Read one option of the current snapshot through a handle
+        template<typename T>
+        T operator[](opt<T> handle) const noexcept {
+            return current()[handle];
+        }
+
+        // Announce that no snapshot returned by current() so far is still
+        // in use, so that the ones replaced since can be freed
+        void quiescent() noexcept {
+            slot_.seen.store(publisher_.epoch_.load(std::memory_order_acquire), std::memory_order_release);
+        }
+
+    private:
+        friend class published_options;
+
+        reader(published_options& publisher, ReaderSlot& slot) noexcept
+            : publisher_(publisher)
+            , slot_(slot)
+        {
+        }
+
+        published_options& publisher_;
+        ReaderSlot& slot_;
+    };
+
+    // Publish initial, a result of schema; the schema must outlive the publisher
+    published_options(const schema& schema, ParseResultValue initial)
+        : schema_(schema)
+        , current_(new options_snapshot(schema, std::move(initial)))
+        , file_(schema.file_)
+    {
+    }
+
+    published_options(const published_options&) = delete;
+    published_options& operator=(const published_options&) = delete;
+
+    // Every reader must have been destroyed
+    ~published_options() {
+        delete current_.load(std::memory_order_relaxed);
+    }
+
+    // Register the calling thread as a reader
+    reader register_reader() {
+        const std::lock_guard lock(writer_);
+        auto free = std::ranges::find(readers_, false, &ReaderSlot::in_use);
+        ReaderSlot& slot = free != readers_.end() ? *free : readers_.emplace_back();
+        slot.in_use = true;
+        slot.seen.store(epoch_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return reader(*this, slot);
+    }
+
+    // The schema that update() parses with
+    const schema& source() const noexcept { return schema_; }
+
+    // Replace the current snapshot with one of result
+    void publish(ParseResultValue result) {
+        std::unique_ptr<const options_snapshot> snapshot =
+            std::make_unique<const options_snapshot>(schema_, std::move(result));
+        const std::lock_guard lock(writer_);
+        retired_.reserve(retired_.size() + 1);  // nothing throws once readers can see the swap
+        const options_snapshot* replaced = current_.exchange(snapshot.release(), std::memory_order_acq_rel);
+        const std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        retired_.push_back(Retired{std::unique_ptr<const options_snapshot>(replaced), epoch});
+        reclaim_retired();
+    }
+
+    // Parse args with the schema and publish the result; on error the
+    // current snapshot stays published and the error is returned. The
+    // config file layer is the one last read by a config_watcher, if
+    // any, so update() and reloads agree on the file's contents.
+    ParseStatus update(std::span<const char* const> args) {
+        return publish_parsed(parse(args));
+    }
+
+    // Same for tokens such as those of ResponseFiles::expand()
+    ParseStatus update(std::span<const std::string_view> args) {
+        return publish_parsed(parse(args));
+    }
+
+    // Free the retired snapshots that every reader has passed a quiescent
+    // state since; returns how many were freed
+    std::size_t reclaim() {
+        const std::lock_guard lock(writer_);
+        return reclaim_retired();
+    }
+
+private:
+    friend class config_watcher;
+
+    struct Retired {
+        std::unique_ptr<const options_snapshot> snapshot;
+        std::uint64_t epoch;  // epoch_ once it was replaced
+    };
+
+    // The current config file layer, which a reload may replace
+    std::shared_ptr<const detail::ConfigFileLayer> config_file() {
+        const std::lock_guard lock(writer_);
+        return file_;
+    }
+
+    void replace_config_file(std::shared_ptr<const detail::ConfigFileLayer> file) {
+        const std::lock_guard lock(writer_);
+        file_ = std::move(file);
+    }
+
+    template<typename Args>
+    ParseOutcome parse(const Args& args) {
+        const std::shared_ptr<const detail::ConfigFileLayer> file = config_file();
+        return ParseOutcome{schema_.parse_owned(ArgMap{}, args, file.get())};
+    }
+
+    ParseStatus publish_parsed(ParseOutcome outcome) {
+        if (!outcome.result) {
+            return std::unexpected(std::move(outcome.result.error()));
+        }
+        publish(std::move(*outcome.result));
+        return {};
+    }
+
+    // With writer_ held
+    std::size_t reclaim_retired() {
+        std::uint64_t oldest = UINT64_MAX;
+        for (const ReaderSlot& slot : readers_) {
+            if (slot.in_use) {
+                oldest = std::min(oldest, slot.seen.load(std::memory_order_acquire));
+            }
+        }
+        return std::erase_if(retired_, [&](const Retired& retired) { return retired.epoch <= oldest; });
+    }
+
+    const schema& schema_;
+    std::atomic<const options_snapshot*> current_;
+    std::atomic<std::uint64_t> epoch_{0};  // number of publishes
+    // Serializes writers and registration; readers never take it
+    std::mutex writer_;
+    std::deque<ReaderSlot> readers_;
+    std::vector<Retired> retired_;
+    // Entries of the schema's config file as last read; guarded by writer_
+    std::shared_ptr<const detail::ConfigFileLayer> file_;
+};
+
+#ifdef CPPCLIARGS_INOTIFY
+// Reloads published options when a file they were parsed from changes:
+// the config file of their schema or a response file named in args. A
+// background thread waits on inotify for files written, renamed over
+// (as editors save them) or removed in those files' directories. Events
+// that arrive together are handled as one reload, which parses args
+// again with the response files expanded afresh and the config file
+// read again if it changed, and publishes the result. A reload that
+// fails leaves the published snapshot in place; either way on_reload,
+// if set, receives the outcome on the watcher thread. A config file that
+// is read again and parses replaces the publisher's, which update()
+// parses with too; one that fails leaves the last good one in use.
+// When the inotify queue overflows every file is read again. Files
+// included from a response file are read on every reload but are not
+// watched.
+class config_watcher {
+public:
+    using Callback = std::function<void(const ParseStatus&)>;
+
+    // Start watching for published, whose schema must outlive the watcher
+    static std::expected<std::unique_ptr<config_watcher>, ParseErrorInfo> watch(published_options& published,
+                                                                                std::span<const char* const> args,
+                                                                                Callback on_reload = {}) {
+        std::unique_ptr<config_watcher> watcher(new config_watcher(published, args, std::move(on_reload)));
+        if (watcher->inotify_ < 0 || ::pipe2(watcher->wake_, O_CLOEXEC) != 0) {
+            return std::unexpected(ParseErrorInfo{ParseError::InputError, '-', std::string("inotify: ") + std::strerror(errno)});
+        }
+
+        const detail::ConfigFileLayer* file = published.source().file_.get();
+        if (file) {
+            if (auto added = watcher->add(std::string(file->path()), true); !added) {
+                return std::unexpected(ParseErrorInfo{ParseError::ConfigFileError, '-', std::move(added.error())});
+            }
+        }
+        for (std::size_t i = 1; i < watcher->args_.size(); ++i) {
+            const std::string& arg = watcher->args_[i];
+            if (arg.size() > 1 && arg.front() == '@') {
+                if (auto added = watcher->add(arg.substr(1), false); !added) {
+                    return std::unexpected(ParseErrorInfo{ParseError::ResponseFileError, '@', std::move(added.error())});
+                }
+            }
+        }
+
+        watcher->thread_ = std::jthread([self = watcher.get()] { self->run(); });
+        return watcher;
+    }
+
+    config_watcher(const config_watcher&) = delete;
+    config_watcher& operator=(const config_watcher&) = delete;
+
+    ~config_watcher() {
+        if (thread_.joinable()) {
+            const char stop = 0;
+            [[maybe_unused]] const ::ssize_t written = ::write(wake_[1], &stop, 1);
+            thread_.join();
+        }
+        for (int fd : {inotify_, wake_[0], wake_[1]}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+private:
+    // A watched file: its name in the directory inotify watches as wd
+    struct Watch {
+        int wd;
+        std::string name;
+        bool config;
+    };
+
+    config_watcher(published_options& published, std::span<const char* const> args, Callback on_reload)
+        : published_(published)
+        , args_(args.begin(), args.end())
+        , on_reload_(std::move(on_reload))
+        , inotify_(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+    {
+        argv_.reserve(args_.size());
+        for (const std::string& arg : args_) {
+            argv_.push_back(arg.c_str());
+        }
+    }
+
+    std::expected<void, std::string> add(const std::string& path, bool config) {
+        const std::size_t slash = path.rfind('/');
+        const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        const int wd = ::inotify_add_watch(inotify_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE);
+        if (wd < 0) {
+            return std::unexpected(path + ": " + std::strerror(errno));
+        }
+        watches_.push_back(Watch{wd, path.substr(slash + 1), config});
+        return {};
+    }
+
+    void run() {
+        alignas(::inotify_event) char events[4096];
+        ::pollfd fds[2] = {{inotify_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+        while (true) {
+            if (::poll(fds, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            if (fds[1].revents != 0) {
+                return;
+            }
+
+            // Drain every pending event before reloading once. Events lost
+            // to a full queue may have been for any file, so reload them all.
+            bool changed = false;
+            bool config_changed = false;
+            for (::ssize_t size; (size = ::read(inotify_, events, sizeof(events))) > 0;) {
+                for (::ssize_t offset = 0; offset < size;) {
+                    const auto* event = reinterpret_cast<const ::inotify_event*>(events + offset);
+                    offset += static_cast<::ssize_t>(sizeof(::inotify_event) + event->len);
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        changed = true;
+                        config_changed = true;
+                        continue;
+                    }
+                    if (event->len == 0) {
+                        continue;
+                    }
+                    const std::string_view name(event->name);
+                    for (const Watch& watch : watches_) {
+                        if (watch.wd == event->wd && watch.name == name) {
+                            changed = true;
+                            config_changed = config_changed || watch.config;
+                        }
+                    }
+                }
+            }
+            if (changed) {
+                const ParseStatus status = reload(config_changed);
+                if (on_reload_) {
+                    on_reload_(status);
+                }
+            }
+        }
+    }
+
+    // Parse with the config file read again if it changed, and publish.
+    // A config file that parses replaces the publisher's layer, so that
+    // update() sees it too; one that does not leaves the last good layer
+    // in place for reloads of the response files.
+    ParseStatus reload(bool config_changed) {
+        const schema& source = published_.source();
+        std::shared_ptr<const detail::ConfigFileLayer> file;
+        if (config_changed && source.file_) {
+            file = std::make_shared<const detail::ConfigFileLayer>(source.table_, std::string(source.file_->path()),
+                                                                   std::pmr::get_default_resource());
+        } else {
+            file = published_.config_file();
+        }
+        auto expanded = responses_.expand(argv_);
+        if (!expanded) {
+            return std::unexpected(std::move(expanded.error()));
+        }
+        auto parsed = source.parse_owned(ArgMap{}, *expanded, file.get());
+        if (!parsed) {
+            return std::unexpected(std::move(parsed.error()));
+        }
+        if (config_changed && source.file_) {
+            published_.replace_config_file(std::move(file));
+        }
+        published_.publish(std::move(*parsed));
+        return {};
+    }
+
+    published_options& published_;
+    std::vector<std::string> args_;
+    std::vector<const char*> argv_;  // args_ as C strings for ResponseFiles
+    Callback on_reload_;
+    ResponseFiles responses_;
+    std::vector<Watch> watches_;
+    int inotify_;
+    int wake_[2] = {-1, -1};  // written to stop the thread
+    std::jthread thread_;
+};
+#endif
+
+// A schema together with the command line given to main(). Help is
+// printed from the constructor when -h or --help is given.
+class parser : public schema {
+public:
+    // Constructor with defaults and argc/argv
+    parser(ArgMap defaults, int argc, const char* argv[]) noexcept
+        : parser(Config{.defaults = std::move(defaults)}, argc, argv)
+    {
+    }
+    
+    // Constructor with full Config and argc/argv
+    parser(Config config, int argc, const char* argv[]) noexcept
+        : schema(config)
+        , argc_(argc)
+        , argv_(argv)
+    {
+        // Auto-print help if requested
+        if (schema::help_requested(args())) {
+            std::cout << generate_help(argv[0]);
+            help_was_requested_ = true;
+        }
+    }
+
+    // Constructor with a pmr::Config; the option table is allocated from
+    // the memory resource of config.defaults
+    parser(const pmr::Config& config, int argc, const char* argv[]) noexcept
+        : schema(config)
+        , argc_(argc)
+        , argv_(argv)
+    {
+        // Auto-print help if requested
+        if (schema::help_requested(args())) {
+            std::cout << generate_help(argv[0]);
+            help_was_requested_ = true;
+        }
+    }
+
+    // Parse command line arguments using stored argc/argv
+    ParseResult operator()() const {
+        return parse_owned(ArgMap{}, args(), file_.get());
+    }
+
+    // Parse with the result's map and strings allocated from resource
+    pmr::ParseResult operator()(std::pmr::memory_resource* resource) const {
+        return parse_owned(pmr::ArgMap(resource), args(), file_.get());
+    }
+
+    using schema::parse_into;
+
+    // Parse the stored command line into a caller-owned buffer that can be
+    // reused across parses. String values are views into argv (string
+    // defaults are views into this parser), so both must outlive the
+    // buffer's contents. On error the buffer holds a partial result.
+    ParseStatus parse_into(ResultBuffer& buffer) const {
+        return parse_into(buffer, args());
+    }
+
+    // Parse straight into the members of target that options are bound to.
+    // Bound options that are not given receive their defaults; options
+    // that are not bound are validated but not stored.
+    template<typename Struct>
+    ParseStatus parse_into(Struct& target, const bindings<Struct>& bound) const {
+        return parse_into(target, bound, args());
+    }
+
+    // Parse without copying strings into a fresh ResultBuffer
+    BorrowedParseResult parse_borrowed() const {
+        ResultBuffer buffer;
+        auto parsed = parse_into(buffer);
+        if (!parsed) {
+            return std::unexpected(std::move(parsed.error()));
+        }
+        return buffer;
+    }
+    
+    using schema::help_requested;
+
+    // Check if help was requested (simpler name)
+    bool help_requested() const {
+        return help_was_requested_;
+    }
+    
+    // NEW: Report error with auto-generated help
+    template<typename T>
+    void report_error(const std::expected<T, ParseErrorInfo>& result) const {
+        if (!result) {
+            std::cerr << "❌ " << result.error().to_string() << "\n\n";
+            std::cout << generate_help(argv_ ? argv_[0] : "program");
+        }
+    }
+
+private:
+    std::span<const char* const> args() const noexcept {
+        return std::span<const char* const>(argv_, static_cast<std::size_t>(argc_));
+    }
+
+    // Stored command line arguments (when using improved constructor)
+    int argc_ = 0;
+    const char** argv_ = nullptr;
+    bool help_was_requested_ = false;
+};
+
+// Option descriptor for fixed_parser; nothing in it owns memory. List
+// options need storage and are rejected with TypeMismatch when given.
+struct FixedOption {
+    char short_name;
+    std::string_view long_name = {};
+    BorrowedArgValue default_value = {};
+    bool required = false;
+    std::string_view help = {};
+};
+
+// Error info that does not own memory. detail views argv, the parser's
+// options or a literal; index is the argv position of the offending token
+// (-1 if there is none).
+struct FixedParseErrorInfo {
+    ParseError error;
+    char argument;
+    int index;
+    std::string_view detail;
+
+    // Same format as ParseErrorInfo::to_string(), written without allocating
+    void write(std::ostream& out) const {
+        out << error_message(error) << " for '-" << argument << "'";
+        if (!detail.empty()) {
+            out << ": " << detail;
+        }
+    }
+
+    std::string to_string() const {
+        return ParseErrorInfo{error, argument, std::string(detail)}.to_string();
+    }
+};
+
+template<std::size_t Capacity>
+class fixed_parser;
+
+namespace detail {
+
+// FixedOption list kept in inline arrays, with one spare entry for the
+// implicit -h. Provides the lookups walk_arguments needs.
+template<std::size_t Capacity>
+class FixedOptionTable {
+public:
+    FixedOptionTable() = default;
+
+    explicit FixedOptionTable(std::initializer_list<FixedOption> options) noexcept {
+        for (const FixedOption& option : options) {
+            if (size_ == Capacity) {
+                overflow_ = true;
+                break;
+            }
+            add(option);
+        }
+
+        // Always add -h for help if not present
+        if (!contains('h')) {
+            add(FixedOption{.short_name = 'h', .long_name = "help", .default_value = false});
+        }
+    }
+
+    OptionSlot slot(char key) const noexcept {
+        const std::uint8_t index = index_[static_cast<unsigned char>(key)];
+        if (index == 0) {
+            return {};
+        }
+        const FixedOption& option = options_[index - 1];
+        return OptionSlot{
+            .type = value_type_of(option.default_value),
+            .required = option.required,
+            .default_index = static_cast<std::uint16_t>(index - 1)
+        };
+    }
+
+    bool contains(char key) const noexcept { return index_[static_cast<unsigned char>(key)] != 0; }
+
+    const FixedOption& option(char key) const noexcept { return options_[index_[static_cast<unsigned char>(key)] - 1]; }
+
+    std::span<const FixedOption> options() const noexcept { return std::span(options_).first(size_); }
+
+    std::string_view long_name(char key) const noexcept {
+        return contains(key) ? option(key).long_name : std::string_view{};
+    }
+
+    const std::bitset<256>& required() const noexcept { return required_; }
+
+    // More options were given than Capacity
+    bool overflow() const noexcept { return overflow_; }
+
+    // Capacity is small in this mode, so a scan beats building a hash
+    // table (which would need scratch memory)
+    char find_long(std::string_view name) const noexcept {
+        for (const FixedOption& option : options()) {
+            if (!option.long_name.empty() && option.long_name == name) {
+                return option.short_name;
+            }
+        }
+        return '\0';  // Not found
+    }
+
+private:
+    void add(const FixedOption& option) noexcept {
+        options_[size_] = option;
+        index_[static_cast<unsigned char>(option.short_name)] = static_cast<std::uint8_t>(++size_);
+        if (option.required) {
+            required_.set(static_cast<unsigned char>(option.short_name));
+        }
+    }
+
+    static_assert(Capacity < 255, "fixed_parser supports at most 254 options");
+
+    std::array<FixedOption, Capacity + 1> options_{};
+    std::array<std::uint8_t, 256> index_{};
+    std::size_t size_ = 0;
+    std::bitset<256> required_;
+    bool overflow_ = false;
+};
+
+} // namespace detail
+
+// Result of fixed_parser: values in an inline array, looked up through the
+// parser's table. The parser and argv must outlive it.
+template<std::size_t Capacity>
+class FixedParseResultValue {
+public:
+    explicit FixedParseResultValue(const detail::FixedOptionTable<Capacity>& table) noexcept
+        : table_(&table)
+    {
+        for (const FixedOption& option : table.options()) {
+            values_[table.slot(option.short_name).default_index] = option.default_value;
+        }
+    }
+
+    bool contains(char key) const noexcept { return table_->contains(key); }
+
+    // Subscript operator
+    const BorrowedArgValue& operator[](char key) const { return at(key); }
+    const BorrowedArgValue& at(char key) const {
+        if (!contains(key)) {
+            throw std::out_of_range("cppcliargs: unknown argument");
+        }
+        return values_[table_->slot(key).default_index];
+    }
+
+    // Template-based typed getter (use std::string_view for strings)
+    template<typename T>
+    T get(char key) const {
+        return std::get<T>(at(key));
+    }
+
+private:
+    friend class fixed_parser<Capacity>;
+
+    const detail::FixedOptionTable<Capacity>* table_;
+    std::array<BorrowedArgValue, Capacity + 1> values_{};
+};
+
+template<std::size_t Capacity>
+using FixedParseResult = std::expected<FixedParseResultValue<Capacity>, FixedParseErrorInfo>;
+
+// Parser for up to Capacity options that never allocates: options, values
+// and errors live in inline arrays or view argv. Help output and
+// report_error() stream directly instead of building strings.
+template<std::size_t Capacity>
+class fixed_parser {
+public:
+    fixed_parser(std::initializer_list<FixedOption> options, int argc, const char* argv[]) noexcept
+        : table_(options)
+        , argc_(argc)
+        , argv_(argv)
+    {
+        // Auto-print help if requested
+        if (has_help_request()) {
+            write_help(std::cout, argv[0]);
+            help_was_requested_ = true;
+        }
+    }
+
+    // Parse command line arguments using stored argc/argv
+    FixedParseResult<Capacity> operator()() const {
+        if (table_.overflow()) {
+            return std::unexpected(FixedParseErrorInfo{
+                ParseError::InvalidArguments,
+                '\0',
+                -1,
+                "more options than the parser's capacity"
+            });
+        }
+
+        FixedParseResultValue<Capacity> result(table_);
+        auto walked = detail::walk_arguments(table_, std::span<const char* const>(argv_, argc_),
+            [&](char, const detail::OptionSlot& slot, std::string_view value, bool) -> std::expected<void, ParseError> {
+                auto converted = detail::convert_borrowed(slot.type, value);
+                if (!converted) {
+                    return std::unexpected(converted.error());
+                }
+                result.values_[slot.default_index] = *converted;
+                return {};
+            });
+
+        if (!walked) {
+            const detail::RawParseError& raw = walked.error();
+            const std::string_view detail = raw.error == ParseError::MissingRequiredArgument
+                ? table_.long_name(raw.argument)
+                : raw.detail;
+            return std::unexpected(FixedParseErrorInfo{raw.error, raw.argument, raw.index, detail});
+        }
+        return result;
+    }
+
+    // Check if help was requested
+    bool help_requested() const {
+        return help_was_requested_;
+    }
+
+    // Report error with auto-generated help
+    void report_error(const FixedParseResult<Capacity>& result) const {
+        if (!result) {
+            std::cerr << "❌ ";
+            result.error().write(std::cerr);
+            std::cerr << "\n\n";
+            write_help(std::cout, argv_ ? argv_[0] : "program");
+        }
+    }
+
+    // Write help text to out without allocating
+    void write_help(std::ostream& out, std::string_view program_name = "program") const {
+        detail::StreamAppender appender{out};
+        append_help(appender, program_name);
+    }
+
+    // Generate help text
+    std::string generate_help(std::string_view program_name = "program") const {
+        std::string result;
+        append_help(result, program_name);
+        return result;
+    }
+
+private:
+    // Check if -h or --help is present (internal use)
+    bool has_help_request() const {
+        std::span<const char* const> args(argv_, argc_);
+        for (const char* arg_ptr : args.subspan(1)) {
+            std::string_view arg(arg_ptr);
+            if (arg == "-h" || (arg == "--help" && table_.long_name('h') == "help")) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<typename Out>
+    void append_help(Out& result, std::string_view program_name) const {
+        result += "Usage: ";
+        result += program_name;
+        result += " [OPTIONS]\n\nOptions:\n";
+
+        // Generate help lines sorted by short name
+        for (int c = 0; c < 256; ++c) {
+            const auto key = static_cast<char>(static_cast<unsigned char>(c));
+            if (!table_.contains(key)) {
+                continue;
+            }
+
+            const FixedOption& option = table_.option(key);
+            detail::append_help_prefix(result, key, option.long_name);
+            std::visit([&](const auto& default_val) {
+                using T = std::decay_t<decltype(default_val)>;
+
+                // Add help text if present, otherwise show type
+                if (!option.help.empty()) {
+                    result += option.help;
+                } else {
+                    result += detail::type_label<T>();
+                }
+
+                detail::append_help_default(result, default_val, option.required);
+            }, option.default_value);
+            result += "\n";
+        }
+    }
+
+    detail::FixedOptionTable<Capacity> table_;
+
+    int argc_ = 0;
+    const char** argv_ = nullptr;
+    bool help_was_requested_ = false;
+};
+
+// One accepted name of an enum option type
+template<typename E>
+struct choice {
+    std::string_view name;
+    E value;
+};
+
+// Names accepted for an enum option type E in static_parser schemas.
+// Specialize it with a constexpr array of choice<E> called values:
+//
+//   template<>
+//   struct cppcliargs::choices<Mode> {
+//       static constexpr std::array values{
+//           cppcliargs::choice<Mode>{"fast", Mode::fast},
+//           cppcliargs::choice<Mode>{"safe", Mode::safe}
+//       };
+//   };
+template<typename E>
+struct choices;
+
+namespace detail {
+
+// Perfect hash from the names in choices<E> to their entries, built at
+// compile time
+template<typename E>
+struct choice_traits {
+    static constexpr const auto& values = choices<E>::values;
+    static constexpr std::size_t size = values.size();
+
+    using hash_type = PerfectHash<std::array<std::uint32_t, std::max<std::size_t>(size, 1)>,
+                                  std::array<std::uint16_t, std::bit_ceil(std::max<std::size_t>(2 * size, 1))>>;
+
+    static constexpr hash_type hash = [] {
+        std::array<std::string_view, size> names{};
+        for (std::size_t i = 0; i < size; ++i) {
+            names[i] = values[i].name;
+        }
+        hash_type result;
+        if (!result.build(names)) {
+            throw "choices: no perfect hash for the names";
+        }
+        return result;
+    }();
+
+    static constexpr const choice<E>* find(std::string_view name) noexcept {
+        const std::size_t index = hash.find(name);
+        if (index < size && values[index].name == name) {
+            return &values[index];
+        }
+        return nullptr;
+    }
+
+    // First name of value, or "" if it has none
+    static constexpr std::string_view name_of(E value) noexcept {
+        for (const auto& entry : values) {
+            if (entry.value == value) {
+                return entry.name;
+            }
+        }
+        return {};
+    }
+
+    // Append the names separated by '|'
+    template<typename Out>
+    static void append_names(Out& result) {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i != 0) {
+                result += "|";
+            }
+            result += values[i].name;
+        }
+    }
+};
+
+} // namespace detail
+
+// Compile-time option descriptor used by static_parser schemas. T may be
+// an enum with choices<T> specialized.
+template<typename T>
+struct option {
+    using value_type = T;
+
+    char short_name;
+    std::string_view long_name = {};
+    T default_value = {};
+    bool required = false;
+    std::string_view help = {};
+};
+
+namespace detail {
+
+// Everything static_parser derives from Schema::options at compile time
+template<typename Schema>
+struct schema_traits {
+    using options_type = std::remove_cvref_t<decltype(Schema::options)>;
+
+    static constexpr std::size_t size = std::tuple_size_v<options_type>;
+    static_assert(size < 255, "static_parser supports at most 254 options");
+
+    template<std::size_t I>
+    using value_type = typename std::tuple_element_t<I, options_type>::value_type;
+
+    using value_tuple = decltype([]<std::size_t... I>(std::index_sequence<I...>) {
+        return std::tuple<value_type<I>...>{};
+    }(std::make_index_sequence<size>{}));
+
+    // Each option must be reachable by its names, so no two may share one
+    static_assert([]<std::size_t... I>(std::index_sequence<I...>) {
+        const std::array<char, size> names{std::get<I>(Schema::options).short_name...};
+        for (std::size_t i = 0; i < size; ++i) {
+            for (std::size_t j = 0; j < i; ++j) {
+                if (names[i] == names[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }(std::make_index_sequence<size>{}), "static_parser: two options have the same short name");
+
+    static_assert([]<std::size_t... I>(std::index_sequence<I...>) {
+        const std::array<std::string_view, size> names{std::get<I>(Schema::options).long_name...};
+        for (std::size_t i = 0; i < size; ++i) {
+            for (std::size_t j = 0; j < i; ++j) {
+                if (!names[i].empty() && names[i] == names[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }(std::make_index_sequence<size>{}), "static_parser: two options have the same long name");
+
+    // Dispatch table: short name -> option index + 1 (0 = unknown)
+    static constexpr std::array<std::uint8_t, 256> dispatch = [] {
+        std::array<std::uint8_t, 256> table{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((table[static_cast<unsigned char>(std::get<I>(Schema::options).short_name)] =
+                static_cast<std::uint8_t>(I + 1)), ...);
+        }(std::make_index_sequence<size>{});
+        return table;
+    }();
+
+    static constexpr bool has_help_option = dispatch[static_cast<unsigned char>('h')] != 0;
+
+    // List options (std::vector values), which may be repeated
+    static constexpr std::array<bool, size> is_list = [] {
+        std::array<bool, size> lists{};
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((lists[I] = !std::is_void_v<list_item_t<value_type<I>>>), ...);
+        }(std::make_index_sequence<size>{});
+        return lists;
+    }();
+
+    // Required options as a mask over option indices
+    static inline const std::bitset<size> required = [] {
+        std::bitset<size> mask;
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((std::get<I>(Schema::options).required ? (mask.set(I), 0) : 0), ...);
+        }(std::make_index_sequence<size>{});
+        return mask;
+    }();
+
+    template<char C>
+    static constexpr std::size_t index_of() {
+        static_assert(dispatch[static_cast<unsigned char>(C)] != 0, "option not declared in schema");
+        return dispatch[static_cast<unsigned char>(C)] - 1;
+    }
+
+    static constexpr std::array<std::string_view, size> long_names = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<std::string_view, size>{std::get<I>(Schema::options).long_name...};
+    }(std::make_index_sequence<size>{});
+
+    // Option indices of the options that have a long name
+    static constexpr std::size_t long_count = std::ranges::count_if(long_names, [](std::string_view name) {
+        return !name.empty();
+    });
+
+    static constexpr std::array<std::size_t, long_count> long_options = [] {
+        std::array<std::size_t, long_count> result{};
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (!long_names[i].empty()) {
+                result[next++] = i;
+            }
+        }
+        return result;
+    }();
+
+    // Perfect hash over the long names, built at compile time
+    using long_hash_type = PerfectHash<std::array<std::uint32_t, std::max<std::size_t>(long_count, 1)>,
+                                       std::array<std::uint16_t, std::bit_ceil(std::max<std::size_t>(2 * long_count, 1))>>;
+
+    static constexpr long_hash_type long_hash = [] {
+        std::array<std::string_view, long_count> names{};
+        for (std::size_t i = 0; i < long_count; ++i) {
+            names[i] = long_names[long_options[i]];
+        }
+        long_hash_type hash;
+        if (!hash.build(names)) {
+            throw "static_parser: no perfect hash for the schema's long names";
+        }
+        return hash;
+    }();
+
+    static constexpr std::size_t find_long(std::string_view long_name) noexcept {
+        const std::size_t index = long_hash.find(long_name);
+        if (index < long_count && long_names[long_options[index]] == long_name) {
+            return long_options[index];
+        }
+        return size;
+    }
+};
+
+} // namespace detail
+
+// Parsed values of a static_parser: one strongly typed member per option
+template<typename Schema>
+struct static_result {
+    typename detail::schema_traits<Schema>::value_tuple values;
+
+    template<char C>
+    constexpr auto& get() noexcept {
+        return std::get<detail::schema_traits<Schema>::template index_of<C>()>(values);
+    }
+
+    template<char C>
+    constexpr const auto& get() const noexcept {
+        return std::get<detail::schema_traits<Schema>::template index_of<C>()>(values);
+    }
+};
+
+template<typename Schema>
+using StaticParseResult = std::expected<static_result<Schema>, ParseErrorInfo>;
+
+// Parser for a schema known at compile time
+//
+// Schema is a type with a static constexpr tuple of option<T> descriptors:
+//
+//   struct Options {
+//       static constexpr std::tuple options{
+//           cppcliargs::option<int>{.short_name = 'n', .long_name = "count"},
+//           cppcliargs::option<bool>{.short_name = 'v', .long_name = "verbose"}
+//       };
+//   };
+//
+// Supported value types are int, bool, std::string_view, std::int64_t,
+// std::uint64_t, double, ByteSize, std::chrono::nanoseconds, std::vector
+// lists (e.g. std::vector<int>) and enums with choices<T> specialized.
+// String values point into argv (or the schema's default literal), so
+// argv must outlive the result. Two options with the same short name, or
+// the same long name, do not compile.
+template<typename Schema>
+class static_parser {
+    using traits = detail::schema_traits<Schema>;
+
+public:
+    static_parser(int argc, const char* argv[]) noexcept
+        : argc_(argc)
+        , argv_(argv)
+    {
+        // Auto-print help if requested
+        if (has_help_request()) {
+            std::cout << generate_help(argv[0]);
+            help_was_requested_ = true;
+        }
+    }
+
+    // Parse command line arguments using stored argc/argv
+    StaticParseResult<Schema> operator()() const {
+        static_result<Schema> result{default_values(std::make_index_sequence<traits::size>{})};
+        std::bitset<traits::size> seen_args;
+
+        std::span<const char* const> args(argv_, argc_);
+
+        // Skip program name - iterate from args.begin() + 1
+        for (auto it = args.begin() + 1; it != args.end(); ++it) {
+            std::string_view arg(*it);
+            const detail::SplitArgument split = detail::split_argument(arg);
+
+            std::size_t index = traits::size;
+            char arg_char = '\0';
+
+            if (split.kind == detail::SplitArgument::Kind::Skip) {
+                continue;
+            } else if (split.kind == detail::SplitArgument::Kind::Long) {
+                index = traits::find_long(split.long_name);
+                if (index == traits::size) {
+                    if (!traits::has_help_option && split.long_name == "help") {
+                        continue;
+                    }
+                    return std::unexpected(ParseErrorInfo{
+                        ParseError::UnknownArgument,
+                        '-',  // Use '-' for unknown long args
+                        std::string(arg)
+                    });
+                }
+            } else {
+                arg_char = split.short_name;
+                index = static_cast<std::size_t>(traits::dispatch[static_cast<unsigned char>(arg_char)]) - 1;
+                if (index == static_cast<std::size_t>(-1)) {
+                    if (!traits::has_help_option && arg_char == 'h') {
+                        continue;
+                    }
+                    return std::unexpected(ParseErrorInfo{
+                        ParseError::UnknownArgument,
+                        arg_char,
+                        std::string(arg)
+                    });
+                }
+            }
+
+            // Check for duplicate
+            const bool repeated = seen_args.test(index);
+            if (repeated && !traits::is_list[index]) {
+                return std::unexpected(ParseErrorInfo{
+                    ParseError::DuplicateArgument,
+                    short_name(index),
+                    ""
+                });
+            }
+            seen_args.set(index);
+
+            // Dispatch to the typed handler for this option
+            ParseStatus handled;
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((index == I ? (handled = parse_option<I>(result, split, it, args.end(), repeated), 0) : 0), ...);
+            }(std::make_index_sequence<traits::size>{});
+
+            if (!handled) {
+                return std::unexpected(std::move(handled.error()));
+            }
+        }
+
+        // Check all required arguments are present
+        const std::bitset<traits::size> missing = traits::required & ~seen_args;
+        if (missing.any()) {
+            std::bitset<256> missing_names;
+            for (std::size_t i = 0; i < traits::size; ++i) {
+                if (missing.test(i)) {
+                    missing_names.set(static_cast<unsigned char>(short_name(i)));
+                }
+            }
+            return std::unexpected(detail::missing_required_error(missing_names, [](char key) {
+                return traits::long_names[traits::dispatch[static_cast<unsigned char>(key)] - 1];
+            }));
+        }
+
+        return result;
+    }
+
+    // Check if help was requested
+    bool help_requested() const {
+        return help_was_requested_;
+    }
+
+    // Report error with auto-generated help
+    void report_error(const StaticParseResult<Schema>& result) const {
+        if (!result) {
+            std::cerr << "❌ " << result.error().to_string() << "\n\n";
+            std::cout << generate_help(argv_ ? argv_[0] : "program");
+        }
+    }
+
+    // Generate help text
+    std::string generate_help(const std::string& program_name = "program") const {
+        std::string result;
+        result += "Usage: " + program_name + " [OPTIONS]\n\n";
+        result += "Options:\n";
+
+        // Generate help lines sorted by short name
+        for (std::size_t c = 0; c < traits::dispatch.size(); ++c) {
+            const std::size_t index = traits::dispatch[c];
+            if (index != 0) {
+                [&]<std::size_t... I>(std::index_sequence<I...>) {
+                    ((index - 1 == I ? (append_help_line<I>(result), 0) : 0), ...);
+                }(std::make_index_sequence<traits::size>{});
+            } else if (c == 'h' && !traits::has_help_option) {
+                detail::append_help_prefix(result, 'h', "help");
+                result += detail::type_label<bool>();
+                result += "\n";
+            }
+        }
+
+        return result;
+    }
+
+private:
+    template<std::size_t... I>
+    static constexpr typename traits::value_tuple default_values(std::index_sequence<I...>) {
+        return {std::get<I>(Schema::options).default_value...};
+    }
+
+    static char short_name(std::size_t index) noexcept {
+        char name = '\0';
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((index == I ? (name = std::get<I>(Schema::options).short_name, 0) : 0), ...);
+        }(std::make_index_sequence<traits::size>{});
+        return name;
+    }
+
+    // Check if -h or --help is present (internal use)
+    bool has_help_request() const {
+        // --help only counts when it is not claimed by another option
+        constexpr bool long_help = !traits::has_help_option ||
+            traits::long_names[traits::dispatch[static_cast<unsigned char>('h')] - 1] == "help";
+
+        std::span<const char* const> args(argv_, argc_);
+        for (const char* arg_ptr : args.subspan(1)) {
+            std::string_view arg(arg_ptr);
+            if (arg == "-h") {
+                return true;
+            }
+            if (long_help && arg == "--help") {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template<std::size_t I, typename Iterator>
+    static ParseStatus parse_option(static_result<Schema>& result,
+                                    const detail::SplitArgument& split,
+                                    Iterator& it, Iterator end, bool repeated) {
+        using T = typename traits::template value_type<I>;
+        constexpr auto& desc = std::get<I>(Schema::options);
+
+        std::string_view value = split.value;
+        if (!split.has_equals) {
+            if constexpr (std::is_same_v<T, bool>) {
+                if constexpr (!desc.required) {
+                    // Optional bool, presence means true
+                    std::get<I>(result.values) = true;
+                    return {};
+                }
+            }
+
+            // Non-bool types and required bools need a value
+            if (it + 1 >= end) {
+                return std::unexpected(ParseErrorInfo{
+                    ParseError::MissingValue,
+                    desc.short_name,
+                    std::is_same_v<T, bool> ? "required boolean needs explicit value" : ""
+                });
+            }
+            ++it;
+            value = *it;
+        }
+
+        if constexpr (traits::is_list[I]) {
+            // Every occurrence appends; the first replaces the default
+            T& list = std::get<I>(result.values);
+            if (!repeated) {
+                list.clear();
+            }
+            if (auto appended = detail::append_list<detail::list_item_t<T>>(value, list); !appended) {
+                return std::unexpected(ParseErrorInfo{appended.error(), desc.short_name, std::string(value)});
+            }
+        } else {
+            auto converted = detail::convert_value<T>(value);
+            if (!converted) {
+                std::string message(value);
+                if constexpr (std::is_enum_v<T>) {
+                    message += " (expected ";
+                    detail::choice_traits<T>::append_names(message);
+                    message += ")";
+                }
+                return std::unexpected(ParseErrorInfo{converted.error(), desc.short_name, std::move(message)});
+            }
+            std::get<I>(result.values) = *converted;
+        }
+        return {};
+    }
+
+    template<std::size_t I>
+    static void append_help_line(std::string& result) {
+        using T = typename traits::template value_type<I>;
+        constexpr auto& desc = std::get<I>(Schema::options);
+
+        detail::append_help_prefix(result, desc.short_name, desc.long_name);
+
+        // Add help text if present, otherwise show type
+        if (!desc.help.empty()) {
+            result += desc.help;
+        } else {
+            result += detail::type_label<T>();
+        }
+
+        detail::append_help_default(result, desc.default_value, desc.required);
+        result += "\n";
+    }
+
+    int argc_ = 0;
+    const char** argv_ = nullptr;
+    bool help_was_requested_ = false;
 };
 
 } // namespace cppcliargs
@@ -0,0 +1,487 @@
+// Microbenchmarks for parser construction, parsing, help generation, error
+// paths, numeric arrays, snapshots, record streams and parallel batches.
+// Prints one JSON document so results can be compared from release to
+// release:
+//
+//   cppcliargs_bench [-t <ms per case>] [-o <output.json>]
+
+#include "cppcliargs.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Count heap allocations so each case can report allocations per run
+static std::atomic<std::size_t> allocation_count = 0;
+
+// Out of line so that GCC does not see free() inlined next to the
+// operator new it pairs with (-Wmismatched-new-delete)
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+static void release(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+namespace {
+
+using namespace cppcliargs;
+
+// Keeps results observable so the measured work is not optimized away
+volatile std::size_t sink = 0;
+
+struct Measurement {
+    double ns_per_run = 0;
+    double allocations_per_run = 0;
+    std::size_t runs = 0;
+};
+
+// Repeat run until the time budget is spent (at least three runs)
+template<typename Run>
+Measurement measure(std::chrono::milliseconds budget, Run&& run) {
+    using clock = std::chrono::steady_clock;
+
+    run();  // warm up caches and lazily sized buffers
+
+    std::size_t runs = 0;
+    const std::size_t allocations_before = allocation_count;
+    const auto start = clock::now();
+    auto elapsed = clock::duration::zero();
+    do {
+        run();
+        ++runs;
+        elapsed = clock::now() - start;
+    } while (runs < 3 || elapsed < budget);
+
+    return Measurement{
+        .ns_per_run = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(runs),
+        .allocations_per_run = static_cast<double>(allocation_count - allocations_before) / static_cast<double>(runs),
+        .runs = runs
+    };
+}
+
+// Option characters usable in a schema: every byte except '\0', '-', '='
+// and the implicit 'h'
+std::vector<char> option_keys(std::size_t count) {
+    std::vector<char> keys;
+    for (int byte = 1; byte < 256 && keys.size() < count; ++byte) {
+        const char key = static_cast<char>(byte);
+        if (key != '-' && key != '=' && key != 'h') {
+            keys.push_back(key);
+        }
+    }
+    return keys;
+}
+
+// Schema of count options cycling through int, bool and string, with a
+// long name on every other option and help text on all of them
+Config make_config(std::size_t count) {
+    Config config;
+    const std::vector<char> keys = option_keys(count);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        const char key = keys[i];
+        switch (i % 3) {
+            case 0: config.defaults[key] = static_cast<int>(i); break;
+            case 1: config.defaults[key] = false; break;
+            default: config.defaults[key] = "default.txt"; break;
+        }
+        if (i % 2 == 0) {
+            config.long_names[key] = "option-" + std::to_string(i);
+        }
+        config.help[key] = "Help text for option " + std::to_string(i);
+    }
+    return config;
+}
+
+// Command line that sets every option once and is padded up to
+// token_count tokens (not counting the program name) by repeating the
+// integer list option --pad, so that every token is an option
+struct ArgvLine {
+    std::vector<std::string> storage;
+    std::vector<const char*> argv;
+};
+
+ArgvLine make_command_line(const Config& config, std::size_t token_count) {
+    ArgvLine line;
+    line.storage.reserve(token_count + 1);
+    line.storage.emplace_back("bench");
+
+    for (const auto& [key, value] : config.defaults) {
+        const auto long_name = config.long_names.find(key);
+        std::string name = long_name != config.long_names.end()
+            ? "--" + long_name->second
+            : std::string{'-', key};
+
+        if (std::holds_alternative<bool>(value)) {
+            line.storage.push_back(std::move(name));
+        } else if (std::holds_alternative<int>(value)) {
+            line.storage.push_back(std::move(name));
+            line.storage.emplace_back("12345");
+        } else if (std::holds_alternative<std::vector<int>>(value)) {
+            line.storage.push_back(std::move(name) + "=7");
+        } else {
+            line.storage.push_back(std::move(name) + "=input.txt");
+        }
+    }
+    while (line.storage.size() <= token_count) {
+        line.storage.emplace_back("--pad=7");
+    }
+
+    line.argv.reserve(line.storage.size());
+    for (const std::string& token : line.storage) {
+        line.argv.push_back(token.c_str());
+    }
+    return line;
+}
+
+class JsonWriter {
+public:
+    void begin(std::string_view group, std::string_view mode) {
+        out_ << (first_ ? "\n" : ",\n") << "    {\"group\": \"" << group << "\", \"mode\": \"" << mode << "\"";
+        first_ = false;
+    }
+
+    template<typename T>
+    void field(std::string_view name, const T& value) {
+        out_ << ", \"" << name << "\": " << value;
+    }
+
+    void end(const Measurement& m) {
+        field("ns_per_run", m.ns_per_run);
+        field("allocations_per_run", m.allocations_per_run);
+        field("runs", m.runs);
+        out_ << "}";
+    }
+
+    std::string finish(std::chrono::milliseconds budget) const {
+        std::ostringstream document;
+        document << "{\n  \"library\": \"cppcliargs\",\n  \"budget_ms\": " << budget.count()
+                 << ",\n  \"results\": [" << out_.str() << "\n  ]\n}\n";
+        return document.str();
+    }
+
+private:
+    std::ostringstream out_;
+    bool first_ = true;
+};
+
+void bench_construction(JsonWriter& json, std::chrono::milliseconds budget, std::size_t options) {
+    const Config config = make_config(options);
+    const char* argv[] = {"bench"};
+
+    json.begin("construct", "config");
+    json.field("options", options);
+    json.end(measure(budget, [&] {
+        const parser p(config, 1, argv);
+        sink = sink + p.help_requested();
+    }));
+}
+
+void bench_parse(JsonWriter& json, std::chrono::milliseconds budget, std::size_t options, std::size_t tokens) {
+    // The last option becomes the --pad list that fills long command lines
+    Config config = make_config(options);
+    const char pad = option_keys(options).back();
+    config.defaults[pad] = std::vector<int>{};
+    config.long_names[pad] = "pad";
+    ArgvLine line = make_command_line(config, tokens);
+    if (line.argv.size() - 1 > tokens) {
+        return;  // this many options do not fit in so few tokens
+    }
+    const parser p(config, static_cast<int>(line.argv.size()), line.argv.data());
+    ResultBuffer buffer;
+    if (const auto status = p.parse_into(buffer); !status) {
+        std::cerr << "benchmark command line does not parse: " << status.error().to_string() << "\n";
+        std::exit(1);
+    }
+
+    auto report = [&](std::string_view mode, const Measurement& m) {
+        json.begin("parse", mode);
+        json.field("options", options);
+        json.field("tokens", tokens);
+        json.field("ns_per_token", m.ns_per_run / static_cast<double>(tokens));
+        json.end(m);
+    };
+
+    report("owned", measure(budget, [&] {
+        const auto result = p();
+        sink = sink + result.has_value();
+    }));
+
+    report("parse_into", measure(budget, [&] {
+        const auto status = p.parse_into(buffer);
+        sink = sink + status.has_value();
+    }));
+}
+
+void bench_help(JsonWriter& json, std::chrono::milliseconds budget, std::size_t options) {
+    const Config config = make_config(options);
+    const char* argv[] = {"bench"};
+    const parser p(config, 1, argv);
+
+    std::size_t bytes = 0;
+    const Measurement m = measure(budget, [&] {
+        const std::string help = p.generate_help("bench");
+        bytes = help.size();
+        sink = sink + bytes;
+    });
+
+    json.begin("help", "generate_help");
+    json.field("options", options);
+    json.field("bytes", bytes);
+    json.end(m);
+}
+
+void bench_errors(JsonWriter& json, std::chrono::milliseconds budget, std::size_t options) {
+    Config config = make_config(options);
+    config.required.insert(option_keys(options).front());
+
+    // The error is at the end of a full command line so the whole walk is timed
+    auto run_case = [&](std::string_view mode, std::vector<const char*> argv) {
+        const parser p(config, static_cast<int>(argv.size()), argv.data());
+        ResultBuffer buffer;
+        const Measurement m = measure(budget, [&] {
+            const auto status = p.parse_into(buffer);
+            sink = sink + (status ? 0 : static_cast<std::size_t>(status.error().error));
+        });
+
+        json.begin("error", mode);
+        json.field("options", options);
+        json.field("tokens", argv.size() - 1);
+        json.end(m);
+    };
+
+    ArgvLine line = make_command_line(config, 0);
+
+    std::vector<const char*> unknown = line.argv;
+    unknown.push_back("--no-such-option");
+    run_case("unknown_argument", std::move(unknown));
+
+    std::vector<const char*> missing(line.argv.begin(), line.argv.begin() + 1);
+    missing.insert(missing.end(), line.argv.begin() + 3, line.argv.end());  // drop the required int
+    run_case("missing_required", std::move(missing));
+
+    std::vector<const char*> invalid = line.argv;
+    invalid[2] = "not-a-number";
+    run_case("invalid_integer", std::move(invalid));
+}
+
+void bench_array(JsonWriter& json, std::chrono::milliseconds budget, std::size_t values) {
+    std::string text;
+    for (std::size_t i = 0; i < values; ++i) {
+        text += (i == 0 ? "" : ",") + std::to_string(i % 1000) + ".125";
+    }
+    std::vector<float> out(values);
+
+    const Measurement m = measure(budget, [&] {
+        const auto written = parse_array<float>(text, out);
+        sink = sink + written.value_or(0);
+    });
+
+    json.begin("array", "parse_array_float");
+    json.field("values", values);
+    json.field("ns_per_value", m.ns_per_run / static_cast<double>(values));
+    json.end(m);
+}
+
+// Restoring a saved result against parsing the same command line again
+void bench_snapshot(JsonWriter& json, std::chrono::milliseconds budget, std::size_t options) {
+    const Config config = make_config(options);
+    ArgvLine line = make_command_line(config, 0);
+    const parser p(config, static_cast<int>(line.argv.size()), line.argv.data());
+    const auto result = p();
+    if (!result) {
+        std::cerr << "benchmark command line does not parse: " << result.error().to_string() << "\n";
+        std::exit(1);
+    }
+    const std::string blob = p.save_snapshot(*result);
+    const auto path = (std::filesystem::temp_directory_path() / "cppcliargs_bench.snapshot").string();
+    std::ofstream(path, std::ios::binary) << blob;
+    if (const auto saved = p.load_snapshot(path); !saved) {
+        std::cerr << "benchmark snapshot does not load: " << saved.error().to_string() << "\n";
+        std::exit(1);
+    }
+
+    auto report = [&](std::string_view mode, const Measurement& m) {
+        json.begin("snapshot", mode);
+        json.field("options", options);
+        json.field("bytes", blob.size());
+        json.end(m);
+    };
+
+    report("save", measure(budget, [&] {
+        sink = sink + p.save_snapshot(*result).size();
+    }));
+
+    report("load", measure(budget, [&] {
+        const auto snapshot = p.load_snapshot(path);
+        sink = sink + (snapshot && snapshot->contains('n'));
+    }));
+
+    std::filesystem::remove(path);
+}
+
+// Records per second through parse_stream() with one parser
+void bench_stream(JsonWriter& json, std::chrono::milliseconds budget, std::size_t records) {
+    const Config config{
+        .defaults = {{'n', 0}, {'v', false}, {'f', ""}, {'t', 1}},
+        .long_names = {{'n', "count"}, {'f', "file"}, {'t', "threads"}}
+    };
+    const char* argv[] = {"bench"};
+    const parser p(config, 1, argv);
+
+    std::string input;
+    for (std::size_t i = 0; i < records; ++i) {
+        input += "tool --count=" + std::to_string(i) + " -v --file 'jobs/input " + std::to_string(i % 100) + ".txt' -t 8\n";
+    }
+
+    const Measurement m = measure(budget, [&] {
+        std::istringstream in(input);
+        std::size_t valid = 0;
+        const auto parsed = p.parse_stream(in, [&](std::size_t, const ParseStatus& status, const ResultBuffer&) {
+            valid += status.has_value();
+        });
+        sink = sink + valid + parsed.value_or(0);
+    });
+
+    json.begin("stream", "parse_stream");
+    json.field("records", records);
+    json.field("bytes", input.size());
+    json.field("records_per_second", static_cast<double>(records) * 1e9 / m.ns_per_run);
+    json.end(m);
+}
+
+// Scaling curve of parse_batch() over worker counts up to one per hardware thread
+void bench_batch(JsonWriter& json, std::chrono::milliseconds budget, std::size_t lines) {
+    const Config config{
+        .defaults = {{'n', 0}, {'v', false}, {'f', ""}, {'t', 1}},
+        .long_names = {{'n', "count"}, {'f', "file"}, {'t', "threads"}}
+    };
+    const char* argv[] = {"bench"};
+    const parser p(config, 1, argv);
+
+    std::vector<std::string> counts;
+    std::vector<std::vector<std::string_view>> tokens;
+    counts.reserve(lines);
+    tokens.reserve(lines);
+    for (std::size_t i = 0; i < lines; ++i) {
+        counts.push_back("--count=" + std::to_string(i));
+        tokens.push_back({"tool", counts.back(), "-v", "--file", "jobs/input.txt", "-t", "8"});
+    }
+    const std::vector<CommandLine> batch(tokens.begin(), tokens.end());
+
+    struct CountingSink : ResultSink {
+        std::size_t valid = 0;
+        void consume(std::size_t, const ParseStatus& status, const ResultBuffer&) override {
+            valid += status.has_value();
+        }
+    };
+
+    const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> thread_counts;
+    for (unsigned threads = 1; threads < hardware; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(hardware);
+
+    double single_thread_ns = 0;
+    for (unsigned threads : thread_counts) {
+        const Measurement m = measure(budget, [&] {
+            CountingSink counter;
+            p.parse_batch(batch, counter, threads);
+            sink = sink + counter.valid;
+        });
+        if (threads == 1) {
+            single_thread_ns = m.ns_per_run;
+        }
+
+        json.begin("batch", "parse_batch");
+        json.field("lines", lines);
+        json.field("threads", threads);
+        json.field("lines_per_second", static_cast<double>(lines) * 1e9 / m.ns_per_run);
+        json.field("speedup", single_thread_ns / m.ns_per_run);
+        json.end(m);
+    }
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+    const parser args({{'t', 20}, {'o', ""}}, argc, argv);
+    if (args.help_requested()) {
+        return 0;
+    }
+    const auto parsed = args();
+    if (!parsed) {
+        args.report_error(parsed);
+        return 1;
+    }
+    const std::chrono::milliseconds budget(parsed->get<int>('t'));
+
+    // Short option names cap a schema at 252 options
+    const std::size_t schema_sizes[] = {2, 16, 64, 252};
+    const std::size_t token_counts[] = {10, 100, 1'000, 10'000, 100'000, 1'000'000};
+
+    JsonWriter json;
+    for (std::size_t options : schema_sizes) {
+        bench_construction(json, budget, options);
+        for (std::size_t tokens : token_counts) {
+            bench_parse(json, budget, options, tokens);
+        }
+        bench_help(json, budget, options);
+        bench_errors(json, budget, options);
+        bench_snapshot(json, budget, options);
+    }
+    for (std::size_t values : {10, 1'000, 100'000}) {
+        bench_array(json, budget, values);
+    }
+    for (std::size_t records : {1'000, 100'000}) {
+        bench_stream(json, budget, records);
+    }
+    bench_batch(json, budget, 1'000'000);
+
+    const std::string document = json.finish(budget);
+    const std::string& output = parsed->get<std::string>('o');
+    if (output.empty()) {
+        std::cout << document;
+    } else {
+        std::ofstream(output) << document;
+    }
+    return 0;
+}
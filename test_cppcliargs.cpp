@@ -1,7 +1,116 @@
+// The checks below are assert()s, which Release builds must run as well
+#undef NDEBUG
+
 #include "cppcliargs.hpp"
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
+#include <new>
+#include <numeric>
 #include <sstream>
+#include <thread>
+
+// Count heap allocations (from any thread) so tests can require that none happen
+static std::atomic<std::size_t> allocation_count = 0;
+
+// Out of line so that GCC does not see free() inlined next to the
+// operator new it pairs with (-Wmismatched-new-delete)
+#if defined(_MSC_VER)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+static void release(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+// setenv()/unsetenv() are POSIX; Windows has _putenv_s(), where an empty
+// value removes the variable
+static void set_env(const char* name, const char* value) {
+#ifdef _WIN32
+    _putenv_s(name, value);
+#else
+    ::setenv(name, value, 1);
+#endif
+}
+
+static void unset_env(const char* name) {
+#ifdef _WIN32
+    _putenv_s(name, "");
+#else
+    ::unsetenv(name);
+#endif
+}
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    release(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    release(ptr);
+}
+
+// Compile-time schema for static_parser tests
+struct StaticOptions {
+    static constexpr std::tuple options{
+        cppcliargs::option<int>{.short_name = 'n', .long_name = "count", .required = true},
+        cppcliargs::option<bool>{.short_name = 'v', .long_name = "verbose"},
+        cppcliargs::option<std::string_view>{.short_name = 'f', .long_name = "file", .default_value = "in.txt"}
+    };
+};
+
+// Compile-time schema with a list option
+struct StaticListOptions {
+    static constexpr std::tuple options{
+        cppcliargs::option<std::vector<int>>{.short_name = 'i', .long_name = "ids"}
+    };
+};
+
+// Enum option type with its accepted names
+enum class Mode { fast, safe, debug };
+
+template<>
+struct cppcliargs::choices<Mode> {
+    static constexpr std::array values{
+        cppcliargs::choice<Mode>{"fast", Mode::fast},
+        cppcliargs::choice<Mode>{"safe", Mode::safe},
+        cppcliargs::choice<Mode>{"debug", Mode::debug}
+    };
+};
+
+struct StaticModeOptions {
+    static constexpr std::tuple options{
+        cppcliargs::option<Mode>{.short_name = 'm', .long_name = "mode", .default_value = Mode::safe,
+                                 .help = "Execution mode"}
+    };
+};
 
 // Simple test to verify new API works
 int main() {
@@ -98,6 +207,1326 @@ int main() {
         std::cout << "✓ Missing required\n";
     }
     
+    // Test 6: Static parser with compile-time schema
+    {
+        const char* argv[] = {"test", "--count=7", "-v"};
+        static_parser<StaticOptions> p(3, argv);
+        assert(!p.help_requested());
+
+        auto result = p();
+        assert(result.has_value());
+        assert(result->get<'n'>() == 7);
+        assert(result->get<'v'>());
+        assert(result->get<'f'>() == "in.txt");
+
+        const char* bad_argv[] = {"test", "-v"};
+        auto missing = static_parser<StaticOptions>(2, bad_argv)();
+        assert(!missing.has_value());
+        assert(missing.error().error == ParseError::MissingRequiredArgument);
+        assert(missing.error().argument == 'n');
+        std::cout << "✓ Static parser\n";
+    }
+    
+    // Test 7: Long names and help text from the option table
+    {
+        const char* argv[] = {"test", "--count=3", "--name", "abc", "-v"};
+        Config config{
+            .defaults = {{'n', 0}, {'s', ""}, {'v', false}},
+            .long_names = {{'n', "count"}, {'s', "name"}},
+            .help = {{'n', "Number of items"}}
+        };
+
+        parser p(config, 5, argv);
+        auto result = p();
+        assert(result.has_value());
+        assert(result.value().get<int>('n') == 3);
+        assert(result.value().get<std::string>('s') == "abc");
+        assert(result.value().get<bool>('v'));
+        assert(result.value().get<bool>('h') == false);
+
+        const std::string help = p.generate_help("test");
+        assert(help.find("-n, --count                 Number of items (default: 0)") != std::string::npos);
+        assert(help.find("-v                        [boolean]") != std::string::npos);
+
+        const char* unknown_argv[] = {"test", "--missing"};
+        auto unknown = parser(config, 2, unknown_argv)();
+        assert(!unknown.has_value());
+        assert(unknown.error().error == ParseError::UnknownArgument);
+        std::cout << "✓ Option table lookups\n";
+    }
+    
+    // Test 8: Perfect-hashed long names
+    {
+        Config config;
+        std::vector<std::string> args_storage = {"test"};
+        for (char c = '0'; c <= 'z'; ++c) {
+            if (std::isalnum(static_cast<unsigned char>(c)) && c != 'h') {
+                config.defaults[c] = 0;
+                config.long_names[c] = std::string("option-") + c;
+                args_storage.push_back(std::string("--option-") + c + "=" + std::to_string(c));
+            }
+        }
+
+        std::vector<const char*> argv;
+        for (const auto& arg : args_storage) {
+            argv.push_back(arg.c_str());
+        }
+
+        parser p(config, static_cast<int>(argv.size()), argv.data());
+        auto result = p();
+        assert(result.has_value());
+        for (const auto& [key, value] : config.defaults) {
+            assert(result.value().get<int>(key) == key);
+        }
+
+        const char* unknown_argv[] = {"test", "--option-"};
+        auto unknown = parser(config, 2, unknown_argv)();
+        assert(!unknown.has_value());
+
+        static_assert(detail::schema_traits<StaticOptions>::find_long("file") == 2);
+        static_assert(detail::schema_traits<StaticOptions>::find_long("files") == 3);
+        std::cout << "✓ Perfect-hashed long names\n";
+    }
+    
+    // Test 9: Borrowed results point into argv
+    {
+        const char* argv[] = {"test", "-f", "data.bin", "-n", "4"};
+        Config config{
+            .defaults = {{'n', 0}, {'f', ""}, {'o', "out.bin"}}
+        };
+
+        parser p(config, 5, argv);
+        auto result = p.parse_borrowed();
+        assert(result.has_value());
+        assert(result->get<int>('n') == 4);
+        assert(result->get<std::string_view>('f').data() == argv[2]);
+        assert(result->get<std::string_view>('o') == "out.bin");
+        assert(!result->contains('x'));
+
+        auto owned = p();
+        assert(owned.value().get<std::string_view>('f') == "data.bin");
+        std::cout << "✓ Borrowed results\n";
+    }
+    
+    // Test 10: Every missing required argument is reported
+    {
+        const char* argv[] = {"test", "-n", "1", "-n", "2"};
+        Config config{
+            .defaults = {{'n', 0}, {'f', ""}, {'o', ""}, {'v', false}},
+            .required = {'n', 'f', 'o'}
+        };
+
+        auto duplicate = parser(config, 5, argv)();
+        assert(!duplicate.has_value());
+        assert(duplicate.error().error == ParseError::DuplicateArgument);
+
+        auto missing = parser(config, 3, argv)();
+        assert(!missing.has_value());
+        assert(missing.error().error == ParseError::MissingRequiredArgument);
+        assert(missing.error().argument == 'f');
+        assert(missing.error().detail == "all missing: -f, -o");
+        std::cout << "✓ Missing required mask\n";
+    }
+    
+    // Test 11: Reusable result buffer
+    {
+        Config config{
+            .defaults = {{'n', 1}, {'f', "default.txt"}, {'v', false}}
+        };
+
+        ResultBuffer buffer;
+        const char* first_argv[] = {"test", "-n", "5", "-f", "a.txt", "-v"};
+        const parser first(config, 6, first_argv);
+        const ParseStatus parsed = first.parse_into(buffer);
+        assert(parsed.has_value());
+        assert(buffer.get<int>('n') == 5);
+        assert(buffer.get<std::string_view>('f') == "a.txt");
+        assert(buffer.get<bool>('v'));
+
+        const char* second_argv[] = {"test", "-n", "7"};
+        const std::size_t before = allocation_count;
+        const ParseStatus reused = first.parse_into(buffer, second_argv);
+        if (allocation_count != before) {
+            std::cerr << "✗ parse_into() into a reused buffer allocated\n";
+            return 1;
+        }
+        assert(reused.has_value());
+        assert(buffer.get<int>('n') == 7);
+        assert(buffer.get<std::string_view>('f') == "default.txt");
+        assert(!buffer.get<bool>('v'));
+
+        const char* bad_argv[] = {"test", "-n", "x"};
+        auto status = parser(config, 3, bad_argv).parse_into(buffer);  // Buffer not read afterwards
+        assert(!status.has_value());
+        assert(status.error().error == ParseError::InvalidIntegerValue);
+        std::cout << "✓ Reusable result buffer\n";
+    }
+    
+    // Test 12: Parser and results backed by a memory resource
+    {
+        // Anything not served from the stack buffer throws std::bad_alloc
+        std::array<std::byte, 16384> storage;
+        std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(),
+                                                  std::pmr::null_memory_resource());
+
+        pmr::Config config{
+            .defaults = pmr::ArgMap(&arena),
+            .long_names = std::pmr::map<char, std::pmr::string>(&arena),
+            .required = std::pmr::set<char>(&arena),
+            .help = std::pmr::map<char, std::pmr::string>(&arena)
+        };
+        config.defaults.emplace('n', 0);
+        config.defaults.emplace('f', pmr::ArgValue(std::in_place_type<std::pmr::string>,
+                                                   "a default long enough to need the heap", &arena));
+        config.long_names.emplace('f', "file");
+        config.required.insert('n');
+
+        const char* argv[] = {"test", "-n", "3", "--file", "a file name long enough to need the heap"};
+        parser p(config, 5, argv);
+
+        auto result = p(&arena);
+        assert(result.has_value());
+        assert(result->get<int>('n') == 3);
+        assert(result->get<std::string_view>('f') == argv[4]);
+        assert(result->values().get_allocator().resource() == &arena);
+
+        ResultBuffer buffer(&arena);
+        const ParseStatus parsed = p.parse_into(buffer);
+        assert(parsed.has_value());
+        assert(buffer.get<int>('n') == 3);
+        std::cout << "✓ Memory resource support\n";
+    }
+    
+    // Test 13: Fixed-capacity parser never allocates
+    {
+        const char* argv[] = {"test", "--count=12", "-f", "input.txt", "-v"};
+        const char* bad_argv[] = {"test", "-n", "oops"};
+        const char* missing_argv[] = {"test"};
+
+        const std::size_t before = allocation_count;
+
+        fixed_parser<4> p({
+            {.short_name = 'n', .long_name = "count", .default_value = 1, .required = true},
+            {.short_name = 'f', .long_name = "file", .default_value = "default.txt"},
+            {.short_name = 'v', .default_value = false}
+        }, 5, argv);
+        auto result = p();
+
+        fixed_parser<4> bad({{.short_name = 'n', .default_value = 0}}, 3, bad_argv);
+        auto bad_result = bad();
+
+        fixed_parser<4> missing({{.short_name = 'n', .long_name = "count", .required = true}}, 1, missing_argv);
+        auto missing_result = missing();
+
+        if (allocation_count != before) {
+            std::cerr << "✗ fixed_parser allocated\n";
+            return 1;
+        }
+
+        assert(!p.help_requested());
+        assert(result.has_value());
+        assert(result->get<int>('n') == 12);
+        assert(result->get<std::string_view>('f').data() == argv[3]);
+        assert(result->get<bool>('v'));
+        assert(!result->get<bool>('h'));
+
+        assert(!bad_result.has_value());
+        assert(bad_result.error().error == ParseError::InvalidIntegerValue);
+        assert(bad_result.error().index == 2);
+        assert(bad_result.error().detail.data() == bad_argv[2]);
+
+        assert(!missing_result.has_value());
+        assert(missing_result.error().error == ParseError::MissingRequiredArgument);
+        assert(missing_result.error().detail == "count");
+        assert(missing_result.error().index == -1);
+
+        // The counter does see the allocating parser
+        parser dynamic({{'n', 0}}, 1, missing_argv);
+        if (allocation_count == before) {
+            std::cerr << "✗ allocations are not counted\n";
+            return 1;
+        }
+        std::cout << "✓ Heap-free fixed parser\n";
+    }
+    
+    // Test 14: Options bound to struct members
+    {
+        struct Settings {
+            int threads = 0;
+            bool verbose = false;
+            std::string input;
+            std::string_view output;
+        };
+
+        Config config{
+            .defaults = {{'t', 4}, {'v', false}, {'i', ""}, {'o', "out.txt"}},
+            .long_names = {{'t', "threads"}}
+        };
+        const auto bound = bindings<Settings>{}
+            .bind('t', &Settings::threads)
+            .bind('v', &Settings::verbose)
+            .bind('i', &Settings::input)
+            .bind('o', &Settings::output);
+
+        const char* argv[] = {"test", "--threads", "16", "-i", "data.csv"};
+        const parser p(config, 5, argv);
+
+        Settings settings;
+        const ParseStatus parsed = p.parse_into(settings, bound);
+        assert(parsed.has_value());
+        assert(settings.threads == 16);
+        assert(!settings.verbose);
+        assert(settings.input == "data.csv");
+        assert(settings.output == "out.txt");
+
+        struct Mismatched {
+            std::string threads;
+        };
+        Mismatched mismatched;
+        auto status = p.parse_into(mismatched, bindings<Mismatched>{}.bind('t', &Mismatched::threads));
+        assert(!status.has_value());
+        assert(status.error().error == ParseError::TypeMismatch);
+        std::cout << "✓ Member bindings\n";
+    }
+    
+    // Test 15: 64-bit and floating-point values
+    {
+        Config config{
+            .defaults = {
+                {'o', std::int64_t{0}},
+                {'s', std::uint64_t{4096}},
+                {'r', 0.5}
+            },
+            .long_names = {{'r', "ratio"}}
+        };
+
+        const char* argv[] = {"test", "-o", "-9000000000", "-s", "18446744073709551615", "--ratio=2.5e-3"};
+        const parser p(config, 6, argv);
+        auto result = p();
+        assert(result.has_value());
+        assert(result->get<std::int64_t>('o') == -9'000'000'000);
+        assert(result->get<std::uint64_t>('s') == UINT64_MAX);
+        assert(result->get<double>('r') == 2.5e-3);
+
+        auto borrowed = p.parse_borrowed();
+        assert(borrowed.has_value());
+        assert(borrowed->get<std::uint64_t>('s') == UINT64_MAX);
+
+        const char* overflow_argv[] = {"test", "-s", "18446744073709551616"};
+        auto overflow = parser(config, 3, overflow_argv)();
+        assert(!overflow.has_value());
+        assert(overflow.error().error == ParseError::InvalidIntegerValue);
+
+        const char* negative_argv[] = {"test", "-s", "-1"};
+        auto negative = parser(config, 3, negative_argv)();
+        assert(!negative.has_value());
+        assert(negative.error().error == ParseError::InvalidIntegerValue);
+
+        const char* ratio_argv[] = {"test", "-r", "1e999"};
+        auto out_of_range = parser(config, 3, ratio_argv)();
+        assert(!out_of_range.has_value());
+        assert(out_of_range.error().error == ParseError::InvalidFloatValue);
+
+        std::string help = p.generate_help("test");
+        assert(help.find("[integer] (default: 4096)") != std::string::npos);
+        assert(help.find("[number] (default: 0.5)") != std::string::npos);
+        std::cout << "✓ 64-bit and floating-point values\n";
+    }
+    
+    // Test 16: List options from repeated flags and comma-separated values
+    {
+        Config config{
+            .defaults = {
+                {'i', std::vector<int>{1, 2}},
+                {'t', std::vector<std::string>{}},
+                {'n', 0}
+            },
+            .long_names = {{'i', "ids"}, {'t', "tags"}}
+        };
+
+        const char* argv[] = {"test", "--ids=10,20,30", "-t", "a,b", "-i", "40", "-t", "c"};
+        const parser p(config, 8, argv);
+
+        auto result = p();
+        assert(result.has_value());
+        assert((result->get<std::vector<int>>('i') == std::vector<int>{10, 20, 30, 40}));
+        assert(result->get<std::span<const int>>('i').size() == 4);
+        assert((result->get<std::vector<std::string>>('t') == std::vector<std::string>{"a", "b", "c"}));
+
+        ResultBuffer buffer;
+        const ParseStatus parsed = p.parse_into(buffer);
+        assert(parsed.has_value());
+        const std::size_t before = allocation_count;
+        const ParseStatus reused = p.parse_into(buffer);
+        if (allocation_count != before) {
+            std::cerr << "✗ parse_into() of list options allocated\n";
+            return 1;
+        }
+        assert(reused.has_value());
+        const auto ids = buffer.get<std::span<const int>>('i');
+        assert(ids.size() == 4 && ids[0] == 10 && ids[3] == 40);
+        const auto tags = buffer.get<std::span<const std::string_view>>('t');
+        assert(tags.size() == 3 && tags[2] == "c");
+
+        // Defaults apply when a list is not given
+        const char* empty_argv[] = {"test"};
+        const parser defaults_only(config, 1, empty_argv);
+        const ParseStatus defaulted = defaults_only.parse_into(buffer);
+        assert(defaulted.has_value());
+        assert(buffer.get<std::span<const int>>('i').size() == 2);
+        assert(buffer.get<std::span<const std::string_view>>('t').empty());
+
+        // Tens of thousands of items in one value
+        std::string many;
+        for (int i = 0; i < 20000; ++i) {
+            many += std::to_string(i);
+            many += ',';
+        }
+        many += "20000";
+        const char* long_argv[] = {"test", "-i", many.c_str()};
+        const parser long_list(config, 3, long_argv);
+        const ParseStatus long_parsed = long_list.parse_into(buffer);
+        assert(long_parsed.has_value());
+        const auto long_ids = buffer.get<std::span<const int>>('i');
+        assert(long_ids.size() == 20001);
+        assert(std::accumulate(long_ids.begin(), long_ids.end(), 0LL) == 20000LL * 20001 / 2);
+
+        const char* bad_argv[] = {"test", "-i", "1,x"};
+        auto bad = parser(config, 3, bad_argv)();
+        assert(!bad.has_value());
+        assert(bad.error().error == ParseError::InvalidIntegerValue);
+
+        const char* twice_argv[] = {"test", "-n", "1", "-n", "2"};
+        auto twice = parser(config, 5, twice_argv)();
+        assert(!twice.has_value());
+        assert(twice.error().error == ParseError::DuplicateArgument);
+
+        struct Shards {
+            std::vector<int> ids;
+            std::vector<std::string_view> tags;
+        };
+        Shards shards;
+        const auto bound = bindings<Shards>{}.bind('i', &Shards::ids).bind('t', &Shards::tags);
+        const ParseStatus bound_parsed = p.parse_into(shards, bound);
+        assert(bound_parsed.has_value());
+        assert((shards.ids == std::vector<int>{10, 20, 30, 40}));
+        assert(shards.tags.size() == 3 && shards.tags[0] == "a");
+
+        const char* static_argv[] = {"test", "--ids", "5,6", "-i", "7"};
+        auto static_result = static_parser<StaticListOptions>(5, static_argv)();
+        assert(static_result.has_value());
+        assert((static_result->get<'i'>() == std::vector<int>{5, 6, 7}));
+
+        const std::string help = p.generate_help("test");
+        assert(help.find("[integer list] (default: 1,2)") != std::string::npos);
+        assert(help.find("[string list]") != std::string::npos);
+        std::cout << "✓ List options\n";
+    }
+    
+    // Test 17: Sizes and durations with unit suffixes
+    {
+        using namespace std::chrono_literals;
+
+        Config config{
+            .defaults = {
+                {'c', ByteSize{512ull << 20}},
+                {'t', std::chrono::nanoseconds(250ms)},
+                {'r', std::chrono::nanoseconds(90s)}
+            },
+            .long_names = {{'c', "cache"}, {'t', "timeout"}}
+        };
+
+        const char* argv[] = {"test", "--cache=4KiB", "--timeout", "2min"};
+        const parser p(config, 4, argv);
+        auto result = p();
+        assert(result.has_value());
+        assert(result->get<ByteSize>('c').bytes == 4096);
+        assert(result->get<std::chrono::nanoseconds>('t') == 120s);
+        assert(result->get<std::chrono::nanoseconds>('r') == 90s);
+
+        auto parse_one = [&](const char* option, const char* value) {
+            const char* one_argv[] = {"test", option, value};
+            return parser(config, 3, one_argv)();
+        };
+        const auto plain_bytes = parse_one("-c", "1048576");
+        assert(plain_bytes->get<ByteSize>('c').bytes == 1u << 20);
+        const auto micros = parse_one("-t", "15us");
+        assert(micros->get<std::chrono::nanoseconds>('t') == 15us);
+        const auto too_large = parse_one("-c", "16777216T");  // 2^64
+        assert(too_large.error().error == ParseError::InvalidSizeValue);
+        const auto bad_unit = parse_one("-c", "12X");
+        assert(bad_unit.error().error == ParseError::InvalidSizeValue);
+        const auto no_unit = parse_one("-t", "250");
+        assert(no_unit.error().error == ParseError::InvalidDurationValue);
+        const auto too_long = parse_one("-t", "200000d");
+        assert(too_long.error().error == ParseError::InvalidDurationValue);
+
+        const std::string help = p.generate_help("test");
+        assert(help.find("[size] (default: 512M)") != std::string::npos);
+        assert(help.find("[duration] (default: 250ms)") != std::string::npos);
+        assert(help.find("(default: 90s)") != std::string::npos);
+        std::cout << "✓ Sizes and durations\n";
+    }
+    
+    // Test 18: Enum choices through a compile-time perfect hash
+    {
+        static_assert(detail::choice_traits<Mode>::find("debug")->value == Mode::debug);
+        static_assert(detail::choice_traits<Mode>::find("slow") == nullptr);
+
+        const char* argv[] = {"test", "--mode=fast"};
+        auto result = static_parser<StaticModeOptions>(2, argv)();
+        assert(result.has_value());
+        assert(result->get<'m'>() == Mode::fast);
+
+        const char* default_argv[] = {"test"};
+        auto defaulted = static_parser<StaticModeOptions>(1, default_argv)();
+        assert(defaulted->get<'m'>() == Mode::safe);
+
+        const char* bad_argv[] = {"test", "-m", "slow"};
+        auto bad = static_parser<StaticModeOptions>(3, bad_argv)();
+        assert(!bad.has_value());
+        assert(bad.error().error == ParseError::InvalidChoice);
+        assert(bad.error().detail == "slow (expected fast|safe|debug)");
+
+        const std::string help = static_parser<StaticModeOptions>(1, default_argv).generate_help("test");
+        assert(help.find("Execution mode {fast|safe|debug} (default: safe)") != std::string::npos);
+        std::cout << "✓ Enum choices\n";
+    }
+    
+    // Test 19: Numeric arrays parsed into caller-provided spans
+    {
+        std::string weights;
+        for (int i = 0; i < 5000; ++i) {
+            weights += std::to_string(i) + ".5,";
+        }
+        weights += "-0.25";
+
+        std::vector<float> storage(6000);
+        auto written = parse_array<float>(weights, storage);
+        assert(written.has_value() && *written == 5001);
+        assert(storage[0] == 0.5f && storage[4999] == 4999.5f && storage[5000] == -0.25f);
+
+        std::array<int, 3> ints{};
+        const auto three = parse_array<int>("7,8,9", std::span<int>(ints));
+        assert(three.value() == 3 && ints[2] == 9);
+        const auto too_many = parse_array<int>("1,2,3,4", std::span<int>(ints));
+        assert(too_many.error() == ParseError::TooManyValues);
+        const auto not_int = parse_array<int>("1,x", std::span<int>(ints));
+        assert(not_int.error() == ParseError::InvalidIntegerValue);
+        const auto trailing = parse_array<float>("1.5,", std::span<float>(storage));
+        assert(trailing.error() == ParseError::InvalidFloatValue);
+
+        // Every delimiter kernel finds the same positions
+        const std::string block = "1,22,333,4444,55555,666666,7777777,88888888,999999999,,0123456789";
+        const auto mask = detail::delimiter_mask()(block.data(), ',');
+        assert(mask == detail::delimiter_mask_scalar(block.data(), ','));
+
+        struct Launch {
+            std::span<float> weights;
+            std::size_t weight_count = 0;
+        };
+        Config config{.defaults = {{'w', "1,2"}}};
+        const char* argv[] = {"test", "-w", "0.1,0.2,0.3"};
+        const parser p(config, 3, argv);
+
+        std::array<float, 8> launch_storage{};
+        Launch launch{launch_storage};
+        const auto bound = bindings<Launch>{}.bind('w', &Launch::weights, &Launch::weight_count);
+        const ParseStatus parsed = p.parse_into(launch, bound);
+        assert(parsed.has_value());
+        assert(launch.weight_count == 3 && launch.weights[2] == 0.3f);
+        assert(launch.weights.data() == launch_storage.data() && launch.weights.size() == 8);
+
+        // A reused struct keeps the span's whole capacity
+        const char* more_argv[] = {"test", "-w", "1,2,3,4,5,6,7,8"};
+        const ParseStatus more = p.parse_into(launch, bound, more_argv);
+        assert(more.has_value() && launch.weight_count == 8 && launch.weights[7] == 8.0f);
+        const char* default_argv[] = {"test"};
+        const ParseStatus defaulted = p.parse_into(launch, bound, default_argv);
+        assert(defaulted.has_value() && launch.weight_count == 2 && launch.weights.size() == 8);
+        std::cout << "✓ Numeric arrays\n";
+    }
+    
+    // Test 20: Response files expanded in place, including nested ones
+    {
+        const auto dir = std::filesystem::temp_directory_path() / "cppcliargs_test_response";
+        std::filesystem::create_directories(dir);
+        auto write = [&](const char* name, std::string_view text) {
+            std::ofstream(dir / name, std::ios::binary) << text;
+            return (dir / name).string();
+        };
+        const std::string inner = write("inner.rsp", "-c 'a b'\n");
+        const std::string outer = write("outer.rsp", "--name \"say \\\"hi\\\"\"\t-v\n@" + inner + "\n");
+        const std::string loop = write("loop.rsp", "-v @" + (dir / "loop.rsp").string());
+        const std::string open_quote = write("quote.rsp", "--name 'unfinished");
+        const std::string literal = write("literal.rsp", "--name '@" + inner + "' \"@x\" \\@y");
+
+        Config config{
+            .defaults = {{'n', "none"}, {'c', "plain"}, {'v', false}, {'i', 0}},
+            .long_names = {{'n', "name"}}
+        };
+        const char* empty_argv[] = {"test"};
+        const parser p(config, 1, empty_argv);
+
+        const std::string outer_arg = "@" + outer;
+        const char* argv[] = {"test", outer_arg.c_str(), "-i", "3"};
+        ResponseFiles files;
+        auto tokens = files.expand(argv);
+        assert(tokens.has_value());
+        assert(tokens->size() == 8);
+        assert((*tokens)[2] == "say \"hi\"" && (*tokens)[5] == "a b");
+
+        ResultBuffer buffer;
+        const ParseStatus parsed = p.parse_into(buffer, *tokens);
+        assert(parsed.has_value());
+        assert(buffer.get<std::string_view>('n') == "say \"hi\"");
+        assert(buffer.get<std::string_view>('c') == "a b");
+        assert(buffer.get<bool>('v'));
+        assert(buffer.get<int>('i') == 3);
+
+        // Expanding again reuses the token storage and maps the files afresh
+#ifdef CPPCLIARGS_MMAP
+        const std::size_t before = allocation_count;
+        const bool expanded = files.expand(argv).has_value();
+        if (allocation_count != before) {
+            std::cerr << "✗ ResponseFiles::expand() allocated\n";
+            return 1;
+        }
+        assert(expanded);
+#endif
+
+        const std::string loop_arg = "@" + loop;
+        const char* loop_argv[] = {"test", loop_arg.c_str()};
+        auto cycle = files.expand(loop_argv);
+        assert(!cycle.has_value() && cycle.error().error == ParseError::ResponseFileError);
+        assert(cycle.error().detail.find("includes itself") != std::string::npos);
+
+        const std::string quote_arg = "@" + open_quote;
+        const char* quote_argv[] = {"test", quote_arg.c_str()};
+        auto unterminated = files.expand(quote_argv);
+        assert(unterminated.error().detail.ends_with("unterminated quote"));
+
+        // A quoted or escaped @ is part of the token, not a file to include
+        const std::string literal_arg = "@" + literal;
+        const char* literal_argv[] = {"test", literal_arg.c_str()};
+        auto kept = files.expand(literal_argv);
+        assert(kept.has_value() && kept->size() == 5);
+        assert((*kept)[2] == "@" + inner && (*kept)[3] == "@x" && (*kept)[4] == "@y");
+
+        const char* missing_argv[] = {"test", "@/no/such/file.rsp"};
+        auto missing = files.expand(missing_argv);
+        assert(!missing.has_value() && missing.error().detail.starts_with("/no/such/file.rsp: "));
+
+        // The file itself is left untouched by in-place tokenization
+        std::ifstream reread(outer);
+        std::string first;
+        std::getline(reread, first);
+        assert(first == "--name \"say \\\"hi\\\"\"\t-v");
+
+        std::filesystem::remove_all(dir);
+        std::cout << "✓ Response files\n";
+    }
+    
+    // Test 21: Environment variables fill in options not given on the command line
+    {
+        Config config{
+            .defaults = {{'t', 1}, {'v', false}, {'p', std::vector<int>{}}, {'o', "out"}},
+            .required = {'o'},
+            .env_prefix = "CPPCLIARGS_TEST_",
+            .env_names = {{'t', "THREADS"}, {'v', "VERBOSE"}, {'p', "PORTS"}, {'o', "OUTPUT"}}
+        };
+        set_env("CPPCLIARGS_TEST_THREADS", "8");
+        set_env("CPPCLIARGS_TEST_VERBOSE", "true");
+        set_env("CPPCLIARGS_TEST_PORTS", "80,443");
+        set_env("CPPCLIARGS_TEST_OUTPUT", "env.txt");
+        set_env("CPPCLIARGS_TEST_UNUSED", "x");
+
+        const char* argv[] = {"test", "-t", "2"};
+        const parser p(config, 3, argv);
+        auto result = p();
+        assert(result.has_value());
+        assert(result->get<int>('t') == 2);  // the command line wins
+        assert(result->get<bool>('v'));
+        assert((result->get<std::vector<int>>('p') == std::vector<int>{80, 443}));
+        assert(result->get<std::string>('o') == "env.txt");  // required, met by the environment
+
+        ResultBuffer buffer;
+        const ParseStatus parsed = p.parse_into(buffer);
+        assert(parsed.has_value());
+        const std::size_t before = allocation_count;
+        const ParseStatus reused = p.parse_into(buffer);
+        if (allocation_count != before) {
+            std::cerr << "✗ parse_into() with environment variables allocated\n";
+            return 1;
+        }
+        assert(reused.has_value());
+        assert(buffer.get<std::string_view>('o') == "env.txt");
+
+        set_env("CPPCLIARGS_TEST_THREADS", "many");
+        const char* empty_argv[] = {"test"};
+        auto bad = parser(config, 1, empty_argv)();
+        assert(!bad.has_value());
+        assert(bad.error().error == ParseError::InvalidIntegerValue);
+        assert(bad.error().detail == "CPPCLIARGS_TEST_THREADS=many");
+
+        unset_env("CPPCLIARGS_TEST_OUTPUT");
+        auto missing = parser(config, 3, argv)();
+        assert(!missing.has_value() && missing.error().error == ParseError::MissingRequiredArgument);
+
+        // Without env_names the environment is not consulted
+        Config plain{.defaults = {{'t', 1}}};
+        auto ignored = parser(plain, 1, empty_argv)();
+        assert(ignored.has_value() && ignored->get<int>('t') == 1);
+
+        for (const char* name : {"THREADS", "VERBOSE", "PORTS", "UNUSED"}) {
+            unset_env(("CPPCLIARGS_TEST_" + std::string(name)).c_str());
+        }
+        std::cout << "✓ Environment variables\n";
+    }
+    
+    // Test 22: Config file layered under the environment and the command line
+    {
+        const auto path = (std::filesystem::temp_directory_path() / "cppcliargs_test.conf").string();
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "# service settings\n"
+                   "[server]\n"
+                   "threads = 3\r\n"
+                   "name = \"from file\"\n"
+                   "\n"
+                   "; short names work too\n"
+                   "l=4\n"
+                   "ports = 1,2\n";
+            for (int i = 0; i < 2000; ++i) {
+                out << "ports = " << i << "\n";
+            }
+        }
+
+        Config config{
+            .defaults = {{'t', 1}, {'n', "default"}, {'l', 0}, {'p', std::vector<int>{}}, {'v', false}},
+            .long_names = {{'t', "threads"}, {'n', "name"}, {'p', "ports"}, {'v', "verbose"}},
+            .env_prefix = "CPPCLIARGS_FILE_TEST_",
+            .env_names = {{'n', "NAME"}},
+            .config_file = path
+        };
+        const char* argv[] = {"test", "-l", "9"};
+        const parser p(config, 3, argv);
+        auto result = p();
+        assert(result.has_value());
+        assert(result->get<int>('t') == 3);
+        assert(result->get<std::string>('n') == "from file");
+        assert(result->get<int>('l') == 9);  // the command line wins
+        assert(result->get<std::vector<int>>('p').size() == 2002);
+        assert(!result->get<bool>('v'));
+
+        set_env("CPPCLIARGS_FILE_TEST_NAME", "from env");
+        ResultBuffer buffer;
+        const ParseStatus parsed = p.parse_into(buffer);
+        assert(parsed.has_value());
+        assert(buffer.get<std::string_view>('n') == "from env");  // the environment beats the file
+        unset_env("CPPCLIARGS_FILE_TEST_NAME");
+
+        // String values view the parser's copy of the file, which copies share
+        const parser copy = p;
+        const ParseStatus copied = copy.parse_into(buffer);
+        assert(copied.has_value());
+        const std::string_view name = buffer.get<std::string_view>('n');
+        assert(name == "from file");
+        const ParseStatus again = copy.parse_into(buffer);
+        assert(again.has_value() && buffer.get<std::string_view>('n').data() == name.data());
+
+        // The file is read once, so changing it does not affect the parser
+        std::filesystem::resize_file(path, 0);
+        const ParseStatus truncated = copy.parse_into(buffer);
+        assert(truncated.has_value() && buffer.get<int>('t') == 3 && buffer.get<std::string_view>('n') == "from file");
+        std::ofstream(path, std::ios::binary) << "threads = 7\n";
+        const ParseStatus rewritten = p.parse_into(buffer);
+        assert(rewritten.has_value() && buffer.get<int>('t') == 3);
+
+        auto rewrite = [&](std::string_view text) {
+            std::ofstream(path, std::ios::binary) << text;
+            return parser(config, 1, argv)();
+        };
+        auto unknown = rewrite("threads = 2\ncolour = red\n");
+        assert(!unknown.has_value() && unknown.error().error == ParseError::UnknownArgument);
+        assert(unknown.error().detail == path + ":2: colour");
+        auto syntax = rewrite("threads\n");
+        assert(!syntax.has_value() && syntax.error().error == ParseError::ConfigFileError);
+        auto invalid = rewrite("threads = lots\n");
+        assert(!invalid.has_value() && invalid.error().error == ParseError::InvalidIntegerValue);
+        assert(invalid.error().detail == "threads = lots");
+        auto twice = rewrite("threads = 1\nt = 2\n");
+        assert(!twice.has_value() && twice.error().error == ParseError::DuplicateArgument);
+
+        std::filesystem::remove(path);
+        auto missing = parser(config, 1, argv)();
+        assert(!missing.has_value() && missing.error().error == ParseError::ConfigFileError);
+        std::cout << "✓ Config files\n";
+    }
+    
+    // Test 23: Binary snapshots of a result read back in place
+    {
+        Config config{
+            .defaults = {
+                {'n', 0}, {'v', false}, {'f', "default"}, {'b', std::int64_t{0}}, {'u', std::uint64_t{0}},
+                {'r', 0.0}, {'i', std::vector<int>{}}, {'t', std::vector<std::string>{}},
+                {'m', ByteSize{}}, {'d', std::chrono::nanoseconds{}}
+            },
+            .long_names = {{'n', "count"}}
+        };
+        const char* argv[] = {"test", "-n", "42", "-v", "-f", "input.txt", "-b", "-9000000000", "-u", "18000000000",
+                              "-r", "0.25", "-i", "1,2,3", "-t", "a,,bc", "-m", "4KiB", "-d", "250ms"};
+        const parser p(config, 20, argv);
+        auto result = p();
+        assert(result.has_value());
+
+        const auto path = (std::filesystem::temp_directory_path() / "cppcliargs_test.snapshot").string();
+        const std::string blob = p.save_snapshot(*result);
+        std::ofstream(path, std::ios::binary) << blob;
+
+        auto snapshot = p.load_snapshot(path);
+        assert(snapshot.has_value());
+        assert(snapshot->get<int>('n') == 42);
+        assert(snapshot->get<bool>('v') && !snapshot->get<bool>('h'));
+        assert(snapshot->get<std::string_view>('f') == "input.txt");
+        assert(snapshot->get<std::int64_t>('b') == -9000000000);
+        assert(snapshot->get<std::uint64_t>('u') == 18000000000u);
+        assert(snapshot->get<double>('r') == 0.25);
+        const auto ints = snapshot->get<std::span<const int>>('i');
+        assert(ints.size() == 3 && ints[2] == 3);
+        const SnapshotStrings tags = snapshot->get<SnapshotStrings>('t');
+        assert(tags.size() == 3 && tags[0] == "a" && tags[1].empty() && tags[2] == "bc");
+        assert(std::ranges::distance(tags.begin(), tags.end()) == 3);
+        assert(snapshot->get<ByteSize>('m').bytes == 4096);
+        assert(snapshot->get<std::chrono::nanoseconds>('d') == std::chrono::milliseconds(250));
+        assert(!snapshot->contains('x'));
+
+        bool threw = false;
+        try {
+            (void)snapshot->get<bool>('n');
+        } catch (const std::bad_variant_access&) {
+            threw = true;
+        }
+        assert(threw);
+
+        // Copies share the loaded bytes, which outlive the original
+        const Snapshot copy = *snapshot;
+        snapshot = std::unexpected(ParseErrorInfo{});
+        assert(copy.get<std::string_view>('f') == "input.txt");
+
+        // A different schema or a damaged blob is rejected
+        Config other = config;
+        other.long_names['n'] = "number";
+        auto mismatch = parser(other, 1, argv).load_snapshot(path);
+        assert(!mismatch.has_value() && mismatch.error().error == ParseError::SnapshotError);
+        assert(mismatch.error().detail.ends_with("saved with a different schema"));
+
+        std::ofstream(path, std::ios::binary) << blob.substr(0, blob.size() - 8);
+        auto truncated = p.load_snapshot(path);
+        assert(!truncated.has_value());
+
+        // So is an entry whose value would lie past the end
+        std::vector<std::uint64_t> corrupt((blob.size() + 7) / 8);
+        std::memcpy(corrupt.data(), blob.data(), blob.size());
+        char* const bytes = reinterpret_cast<char*>(corrupt.data());
+        std::uint32_t entry_count;
+        std::memcpy(&entry_count, bytes + 12, sizeof(entry_count));
+        for (std::uint32_t i = 0; i < entry_count; ++i) {
+            const std::uint32_t count = 0;
+            const std::uint64_t offset = blob.size();
+            std::memcpy(bytes + 288 + i * 16 + 4, &count, sizeof(count));
+            std::memcpy(bytes + 288 + i * 16 + 8, &offset, sizeof(offset));
+        }
+        auto past_end = Snapshot::view(std::span<const char>(bytes, blob.size()), p.schema_hash());
+        assert(!past_end.has_value() && past_end.error().detail == "truncated or corrupt");
+
+        // A loaded snapshot keeps its own copy when the file is rewritten
+        std::ofstream(path, std::ios::binary | std::ios::trunc).flush();
+        assert(copy.get<std::string_view>('f') == "input.txt" && copy.get<int>('n') == 42);
+        assert(copy.get<SnapshotStrings>('t')[2] == "bc");
+        std::filesystem::remove(path);
+        auto missing = p.load_snapshot(path);
+        assert(!missing.has_value());
+        std::cout << "✓ Snapshots\n";
+    }
+    
+    // Test 24: Streams of newline-delimited command lines
+    {
+        Config config{
+            .defaults = {{'n', 0}, {'f', "none"}},
+            .long_names = {{'n', "count"}}
+        };
+        const char* argv[] = {"test"};
+        const parser p(config, 1, argv);
+
+        std::string input = "tool -n 1 -f 'a b'\n\n  \ntool --count=2\r\ntool -n x\ntool -f \"open\n";
+        for (int i = 0; i < 20000; ++i) {
+            input += "tool -n " + std::to_string(i) + " -f " + std::string(static_cast<std::size_t>(i % 97 + 1), 'x') + "\n";
+        }
+        input += "tool -f " + std::string(200000, 'y');  // longer than the read buffer, no final newline
+
+        std::istringstream in(input);
+        std::vector<std::size_t> failed;
+        long long sum = 0;
+        std::size_t last_length = 0;
+        auto records = p.parse_stream(in, [&](std::size_t record, const ParseStatus& status, const ResultBuffer& result) {
+            if (!status) {
+                failed.push_back(record);
+                return;
+            }
+            if (record == 1) {
+                assert(result.get<std::string_view>('f') == "a b");
+            } else if (record == 4) {
+                assert(result.get<int>('n') == 2);
+            }
+            sum += result.get<int>('n');
+            last_length = result.get<std::string_view>('f').size();
+        });
+        assert(records.has_value() && *records == 20005);
+        assert((failed == std::vector<std::size_t>{5, 6}));
+        assert(sum == 1 + 2 + 19999LL * 20000 / 2);
+        assert(last_length == 200000);
+
+        // Returning false stops the stream
+        std::istringstream again(input);
+        std::size_t seen = 0;
+        auto stopped = p.parse_stream(again, [&](std::size_t, const ParseStatus&, const ResultBuffer&) {
+            return ++seen < 3;
+        });
+        assert(stopped.has_value() && *stopped == 3);
+
+        // Each record is handed on before the stream is read past it, as a
+        // daemon fed through a pipe needs
+        struct LineByLine : std::streambuf {
+            std::vector<std::string> lines;
+            std::size_t delivered = 0;
+            std::string current;
+            int_type underflow() override {
+                if (delivered == lines.size()) {
+                    return traits_type::eof();
+                }
+                current = lines[delivered++];
+                setg(current.data(), current.data(), current.data() + current.size());
+                return traits_type::to_int_type(current.front());
+            }
+        };
+        LineByLine live;
+        live.lines = {"tool -n 1\n", "tool -n 2\n", "tool -n 3\n"};
+        std::istream live_in(&live);
+        auto streamed = p.parse_stream(live_in, [&](std::size_t record, const ParseStatus& status,
+                                                    const ResultBuffer& result) {
+            assert(status.has_value() && result.get<int>('n') == static_cast<int>(record));
+            assert(live.delivered == record);
+        });
+        assert(streamed.has_value() && *streamed == 3);
+
+        // Records are validated as written, without the environment or the
+        // config file of the process reading them
+        const auto conf = (std::filesystem::temp_directory_path() / "cppcliargs_test_stream.conf").string();
+        std::ofstream(conf) << "count = 5\n";
+        const Config layered{
+            .defaults = {{'n', 0}, {'o', "none"}},
+            .long_names = {{'n', "count"}},
+            .required = {'o'},
+            .env_prefix = "CPPCLIARGS_STREAM_TEST_",
+            .env_names = {{'o', "OUTPUT"}},
+            .config_file = conf
+        };
+        set_env("CPPCLIARGS_STREAM_TEST_OUTPUT", "env.txt");
+        const parser audit(layered, 1, argv);
+        std::istringstream archived("tool -n 1\ntool -o given.txt\n");
+        auto checked = audit.parse_stream(archived, [&](std::size_t record, const ParseStatus& status,
+                                                        const ResultBuffer& result) {
+            if (record == 1) {
+                assert(!status && status.error().error == ParseError::MissingRequiredArgument);
+            } else {
+                assert(status.has_value() && result.get<std::string_view>('o') == "given.txt");
+                assert(result.get<int>('n') == 0);
+            }
+        });
+        assert(checked.has_value() && *checked == 2);
+        unset_env("CPPCLIARGS_STREAM_TEST_OUTPUT");
+        std::filesystem::remove(conf);
+
+#ifdef CPPCLIARGS_MMAP
+        const auto path = (std::filesystem::temp_directory_path() / "cppcliargs_test.records").string();
+        std::ofstream(path, std::ios::binary) << "tool -n 7\ntool -n 8\n";
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        assert(fd >= 0);
+        int total = 0;
+        auto from_fd = p.parse_stream(fd, [&](std::size_t, const ParseStatus& status, const ResultBuffer& result) {
+            assert(status.has_value());
+            total += result.get<int>('n');
+        });
+        ::close(fd);
+        std::filesystem::remove(path);
+        assert(from_fd.has_value() && *from_fd == 2 && total == 15);
+#endif
+        std::cout << "✓ Record streams\n";
+    }
+    
+    // Test 25: Batches of command lines parsed on several threads
+    {
+        Config config{.defaults = {{'n', 0}, {'f', "none"}}};
+        const char* argv[] = {"test"};
+        const parser p(config, 1, argv);
+
+        std::vector<std::string> values;
+        std::vector<std::vector<std::string_view>> tokens;
+        values.reserve(5000);
+        for (int i = 0; i < 5000; ++i) {
+            values.push_back(i % 7 == 0 ? "bad" : std::to_string(i));
+            tokens.push_back({"tool", "-n", values.back(), "-f", "file"});
+        }
+        const std::vector<CommandLine> lines(tokens.begin(), tokens.end());
+
+        struct OrderedSink : ResultSink {
+            std::size_t next = 0;
+            std::size_t failures = 0;
+            void consume(std::size_t index, const ParseStatus& status, const ResultBuffer& result) override {
+                assert(index == next++);
+                if (!status) {
+                    assert(index % 7 == 0 && status.error().error == ParseError::InvalidIntegerValue);
+                    ++failures;
+                    return;
+                }
+                assert(result.get<int>('n') == static_cast<int>(index));
+                assert(result.get<std::string_view>('f') == "file");
+            }
+        };
+        for (unsigned threads : {1u, 4u}) {
+            OrderedSink sink;
+            p.parse_batch(lines, sink, threads);
+            assert(sink.next == 5000 && sink.failures == 715);
+        }
+
+        // An exception from the sink stops the batch and reaches the caller
+        struct ThrowingSink : ResultSink {
+            void consume(std::size_t index, const ParseStatus&, const ResultBuffer&) override {
+                if (index == 1000) {
+                    throw std::runtime_error("sink full");
+                }
+            }
+        };
+        ThrowingSink throwing;
+        bool threw = false;
+        try {
+            p.parse_batch(lines, throwing, 4);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        assert(threw);
+
+        // Lines are validated as written, without the environment or the
+        // config file of the process validating them
+        const auto conf = (std::filesystem::temp_directory_path() / "cppcliargs_test_batch.conf").string();
+        std::ofstream(conf) << "n = 5\n";
+        const Config layered{
+            .defaults = {{'n', 0}, {'o', "none"}},
+            .required = {'o'},
+            .env_prefix = "CPPCLIARGS_BATCH_TEST_",
+            .env_names = {{'o', "OUTPUT"}},
+            .config_file = conf
+        };
+        set_env("CPPCLIARGS_BATCH_TEST_OUTPUT", "env.txt");
+        const parser audit(layered, 1, argv);
+        const std::vector<std::string_view> missing = {"tool", "-n", "1"};
+        const std::vector<std::string_view> complete = {"tool", "-o", "given.txt"};
+        const std::vector<CommandLine> records = {missing, complete};
+        struct LayerSink : ResultSink {
+            void consume(std::size_t index, const ParseStatus& status, const ResultBuffer& result) override {
+                if (index == 0) {
+                    assert(!status && status.error().error == ParseError::MissingRequiredArgument);
+                } else {
+                    assert(status.has_value() && result.get<std::string_view>('o') == "given.txt");
+                    assert(result.get<int>('n') == 0);
+                }
+            }
+        };
+        LayerSink layer_sink;
+        audit.parse_batch(records, layer_sink, 2);
+        // parse() still applies them
+        assert(audit.parse(std::span<const std::string_view>(missing)).result.has_value());
+        unset_env("CPPCLIARGS_BATCH_TEST_OUTPUT");
+        std::filesystem::remove(conf);
+        std::cout << "✓ Parallel batches\n";
+    }
+    
+    // Test 26: One immutable schema shared by threads, help returned as data
+    {
+        const schema options(Config{
+            .defaults = {{'n', 0}, {'f', "none"}},
+            .long_names = {{'n', "count"}},
+            .required = {'f'}
+        });
+
+        std::ostringstream captured;
+        std::streambuf* const original = std::cout.rdbuf(captured.rdbuf());
+        const char* help_argv[] = {"tool", "--help"};
+        const ParseOutcome help = options.parse(help_argv);
+        std::cout.rdbuf(original);
+        assert(captured.str().empty());  // nothing is printed
+        assert(help.help_requested);
+        assert(!help.result.has_value() && help.result.error().error == ParseError::MissingRequiredArgument);
+        assert(options.generate_help("tool").find("--count") != std::string::npos);
+
+        std::vector<std::jthread> workers;
+        std::atomic<int> parsed_ok = 0;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < 500; ++i) {
+                    const std::string count = std::to_string(t * 1000 + i);
+                    const char* argv[] = {"tool", "--count", count.c_str(), "-f", "x"};
+                    const ParseOutcome outcome = options.parse(argv);
+                    if (!outcome.help_requested && outcome.result && outcome.result->get<int>('n') == t * 1000 + i) {
+                        ++parsed_ok;
+                    }
+                }
+            });
+        }
+        workers.clear();
+        assert(parsed_ok == 2000);
+
+        // parser is a schema bound to one command line
+        const char* argv[] = {"tool", "-f", "y"};
+        const parser p(Config{.defaults = {{'f', "none"}}}, 3, argv);
+        const schema& as_schema = p;
+        const ParseOutcome outcome = as_schema.parse(argv);
+        assert(outcome.result->get<std::string>('f') == "y");
+        assert(!p.help_requested() && !p.help_requested(std::span<const char* const>(argv)));
+        std::cout << "✓ Shared schemas\n";
+    }
+    
+    // Test 27: Typed option handles
+    {
+        schema_builder builder;
+        const opt<int> threads = builder.add('t', 4, "threads", "Worker threads");
+        const opt<bool> verbose = builder.add('v', false);
+        const opt<std::string_view> output = builder.add('o', "out.txt", "output");
+        const opt<std::span<const int>> ports = builder.add('p', std::vector<int>{80});
+        const opt<std::chrono::nanoseconds> timeout = builder.add('d', std::chrono::seconds(5));
+        const opt<std::string_view> input = builder.add_required('i', std::string{});
+        const opt<std::string_view> label = builder.add('l', std::string_view{"nightly"});
+        static_assert(std::is_same_v<decltype(builder.add('z', 1.5)), opt<double>>);
+        assert(threads.key() == 't');
+
+        bool threw = false;
+        try {
+            builder.add('t', 8);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+
+        const schema options = builder.build();
+        const char* argv[] = {"tool", "--threads", "16", "-v", "-p", "1,2", "-i", "in.txt"};
+        ResultBuffer buffer;
+        const ParseStatus parsed = options.parse_into(buffer, argv);
+        assert(parsed.has_value());
+        assert(buffer[threads] == 16);
+        assert(buffer[verbose]);
+        assert(buffer[output] == "out.txt");
+        assert(buffer[ports].size() == 2 && buffer[ports][1] == 2);
+        assert(buffer[timeout] == std::chrono::seconds(5));
+        assert(buffer[input] == "in.txt");
+        assert(buffer[label] == "nightly");
+
+        // Hot loops read through the handle without allocating
+        const std::size_t before = allocation_count;
+        long long total = 0;
+        for (int i = 0; i < 1000; ++i) {
+            total += buffer[threads];
+        }
+        if (allocation_count != before) {
+            std::cerr << "✗ reading through a handle allocated\n";
+            return 1;
+        }
+        assert(total == 16000);
+
+        const char* missing_argv[] = {"tool"};
+        const parser p(builder.config(), 1, missing_argv);
+        auto missing = p();
+        assert(missing.error().error == ParseError::MissingRequiredArgument);
+        std::cout << "✓ Typed option handles\n";
+    }
+    
+    // Test 28: Published options
+    {
+        schema_builder builder;
+        const opt<int> threads = builder.add('t', 4, "threads");
+        const opt<std::string_view> mode = builder.add('m', "fast", "mode");
+        const opt<std::span<const std::string_view>> tags = builder.add('g', std::vector<std::string>{"a"});
+        const schema options = builder.build();
+
+        const char* argv[] = {"tool", "-t", "8", "-g", "x,y"};
+        published_options published(options, *options.parse(argv).result);
+        auto reader = published.register_reader();
+        const options_snapshot& first = reader.current();
+        assert(reader[threads] == 8);
+        assert(first[mode] == "fast" && first.get<std::string_view>('m') == "fast");
+        assert(first[tags].size() == 2 && first[tags][1] == "y");
+
+        // A failed update keeps the published snapshot
+        const std::vector<std::string_view> invalid = {"tool", "-t", "many"};
+        const ParseStatus rejected = published.update(invalid);
+        assert(rejected.error().error == ParseError::InvalidIntegerValue);
+        assert(&reader.current() == &first);
+
+        // Readers keep reading while the options are published again,
+        // announcing a quiescent state after each unit of work
+        std::atomic<bool> done{false};
+        std::atomic<bool> consistent{true};
+        {
+            std::vector<std::jthread> readers;
+            for (int i = 0; i < 4; ++i) {
+                readers.emplace_back([&] {
+                    auto worker = published.register_reader();
+                    while (!done.load()) {
+                        const options_snapshot& current = worker.current();
+                        const int value = current[threads];
+                        if (current[mode] != (value % 2 == 0 ? "fast" : "safe")) {
+                            consistent = false;
+                        }
+                        worker.quiescent();
+                    }
+                });
+            }
+            for (int i = 1; i <= 100; ++i) {
+                const std::string value = std::to_string(8 + i);
+                const std::vector<std::string_view> line = {"tool", "-t", value, "-m", i % 2 == 0 ? "fast" : "safe"};
+                const ParseStatus updated = published.update(line);
+                assert(updated.has_value());
+            }
+            done = true;
+        }
+        assert(consistent);
+        assert(reader[threads] == 108);
+        assert(reader.current()[tags][0] == "a");
+
+        // The first snapshot is still held, so nothing replaced since is freed
+        const std::size_t held = published.reclaim();
+        assert(held == 0);
+        assert(first[threads] == 8 && first[tags][1] == "y");
+        reader.quiescent();
+        const std::size_t freed = published.reclaim();
+        assert(freed == 100);
+        const std::size_t freed_again = published.reclaim();
+        assert(freed_again == 0);
+
+        ArgMap foreign;
+        foreign.emplace('t', std::string("eight"));
+        bool threw = false;
+        try {
+            published.publish(ParseResultValue(foreign));
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw && reader[threads] == 108);
+        std::cout << "✓ Published options\n";
+    }
+    
+#ifdef CPPCLIARGS_INOTIFY
+    // Test 29: Reloading options when their files change
+    {
+        const auto directory = std::filesystem::temp_directory_path() / "cppcliargs_watch_test";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+        const std::string config_path = (directory / "service.conf").string();
+        const std::string response_path = (directory / "service.args").string();
+        auto write = [](const std::string& path, const std::string& text) {
+            std::ofstream(path, std::ios::binary) << text;
+        };
+        write(config_path, "threads = 2\n");
+        write(response_path, "--mode safe\n");
+
+        schema_builder builder;
+        const opt<int> threads = builder.add('t', 1, "threads");
+        const opt<std::string_view> mode = builder.add('m', "fast", "mode");
+        Config config = builder.config();
+        config.config_file = config_path;
+        const schema options(config);
+
+        const std::string response_arg = "@" + response_path;
+        const char* argv[] = {"service", response_arg.c_str()};
+        ResponseFiles responses;
+        published_options published(options, *options.parse(*responses.expand(argv)).result);
+        auto reader = published.register_reader();
+        assert(reader[threads] == 2 && reader[mode] == "safe");
+
+        std::atomic<int> reloads{0};
+        std::atomic<bool> failed{false};
+        auto watcher = config_watcher::watch(published, argv, [&](const ParseStatus& status) {
+            failed = !status.has_value();
+            ++reloads;
+        });
+        assert(watcher.has_value());
+        auto wait_for = [&](int count, int attempts = 500) {
+            for (int i = 0; i < attempts && reloads.load() < count; ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            return reloads.load() >= count;
+        };
+
+        write(config_path, "threads = 3\n");
+        const bool reloaded_1 = wait_for(1);
+        assert(reloaded_1 && !failed);
+        assert(reader[threads] == 3 && reader[mode] == "safe");
+
+        // A file renamed over the old one, as editors save, is seen too
+        write(response_path + ".tmp", "--mode fast -t 5\n");
+        std::filesystem::rename(response_path + ".tmp", response_path);
+        const bool reloaded_2 = wait_for(2);
+        assert(reloaded_2 && !failed);
+        assert(reader[threads] == 5 && reader[mode] == "fast");
+
+        // A reload that fails keeps the published options
+        write(response_path, "--mode fast -t many\n");
+        const bool reloaded_3 = wait_for(3);
+        assert(reloaded_3 && failed);
+        assert(reader[threads] == 5);
+
+        // Files next to the watched ones do not trigger reloads
+        write((directory / "unrelated.txt").string(), "x");
+        const bool reloaded_unrelated = wait_for(4, 50);  // gives up after half a second
+        assert(!reloaded_unrelated && reloads.load() == 3);
+        write(response_path, "--mode safe\n");
+        const bool reloaded_4 = wait_for(4);
+        assert(reloaded_4 && !failed);
+        assert(reader[threads] == 3 && reader[mode] == "safe");
+        write(config_path, "threads = 4\n");
+        const bool reloaded_5 = wait_for(5);
+        assert(reloaded_5 && !failed);
+        assert(reader[threads] == 4);
+
+        // update() parses with the config file as the watcher last read it
+        const ParseStatus updated = published.update(*responses.expand(argv));
+        assert(updated.has_value());
+        assert(reader[threads] == 4 && reader[mode] == "safe");
+
+        // A config file that fails to parse is not kept, so a later change
+        // to a response file is still published
+        write(config_path, "threads = many\n");
+        const bool reloaded_6 = wait_for(6);
+        assert(reloaded_6 && failed);
+        write(response_path, "--mode fast\n");
+        const bool reloaded_7 = wait_for(7);
+        assert(reloaded_7 && !failed);
+        assert(reader[threads] == 4 && reader[mode] == "fast");
+        const ParseStatus updated_again = published.update(*responses.expand(argv));
+        assert(updated_again.has_value());
+        watcher->reset();
+        reader.quiescent();
+        const std::size_t freed = published.reclaim();
+        assert(freed >= 3);
+
+        const char* missing_argv[] = {"service", "@/nonexistent/cppcliargs/args"};
+        auto missing = config_watcher::watch(published, missing_argv);
+        assert(!missing.has_value() && missing.error().error == ParseError::ResponseFileError);
+        std::filesystem::remove_all(directory);
+        std::cout << "✓ Reloading options when their files change\n";
+    }
+#endif
+    
     std::cout << "\nAll tests passed!\n";
     return 0;
 }